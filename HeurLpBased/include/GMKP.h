@@ -0,0 +1,85 @@
+#include <cstddef>
+
+#ifndef GMKP_H_
+#define GMKP_H_
+
+/* public API of the gmkp library: read or create an instance, solve it and get the assignment
+ * every function returns 0 or one of the error codes below, nothing terminates the process
+ * */
+
+// error codes
+#define GMKP_OK 0
+#define GMKP_ERROR_ENVIRONMENT 1 // CPLEX environment or lp not created
+#define GMKP_ERROR_MODEL 2 // columns or rows of the model not added
+#define GMKP_ERROR_PARAMETERS 3 // CPLEX parameter not set
+#define GMKP_ERROR_BOUNDS 4 // bounds of the dive not changed
+#define GMKP_ERROR_OPTIMIZE 5 // LP not optimized
+#define GMKP_ERROR_SOLUTION 6 // LP solution not available
+#define GMKP_ERROR_INSTANCE 7 // instance not read or not valid
+#define GMKP_ERROR_OPTIONS 8 // invalid options
+#define GMKP_ERROR_INFEASIBLE 9 // LP infeasible with the fixings that cannot be undone (warm start)
+
+// strategies
+#define GMKP_STRATEGY_DIVE 0 // LP based dive
+#define GMKP_STRATEGY_BRANCH_AND_BOUND 1 // dive, then branch and bound from its solution until the time limit
+
+struct GmkpInstance {
+	int n; // number of objects
+	int m; // number of knapsacks
+	int r; // number of subsets
+	int *weights; // w(j) [n]
+	int *capacities; // C(i) [m]
+	int *profits; // p(i,j) [n*m], knapsack after knapsack
+	int *classes; // items grouped by class [n]
+	int *indexes; // end of each class in classes [r]
+	int *setups; // s(k) [r]
+	int *b; // b(k) [r]
+};
+
+struct GmkpOptions {
+	double timeLimit; // seconds of the whole solve (0: none)
+	int threads; // threads of the branch and bound
+	int strategy; // GMKP_STRATEGY_...
+	bool exactSubproblems; // exact knapsack subsolver when all y are fixed
+	double integralityTolerance; // LP values this close to 0 or 1 are integral in the dive
+	bool deterministic; // same result for any number of threads
+	bool verbose; // progress printed on the standard output
+};
+
+struct GmkpResult {
+	int error;
+	double objval; // value of the assignment
+	bool feasible;
+	bool optimal; // proven by the branch and bound
+	double bound; // upper bound proven by the branch and bound (0 with GMKP_STRATEGY_DIVE)
+	double gap; // (bound - objval) / bound (0 with GMKP_STRATEGY_DIVE)
+	long long nodes; // nodes of the branch and bound
+	double time; // seconds
+	int n;
+	int m;
+	int r;
+	int *itemKnapsack; // knapsack of each item, -1 if not assigned [n]
+	char *openClasses; // 1 if the class k is open in the knapsack i [m*r, i*r + k]
+};
+
+// instance file in .inc format, or binary format if it starts with the magic (path as given)
+int gmkpReadInstance(const char *path, GmkpInstance &instance);
+
+// same as gmkpReadInstance, from memory
+int gmkpReadInstanceData(const char *data, size_t size, GmkpInstance &instance);
+
+// instance from the data of the caller (copied), itemClass is the class of each item (0-based)
+int gmkpCreateInstance(GmkpInstance &instance, int n, int m, int r, const int *weights, const int *capacities, const int *profits, const int *itemClass, const int *setups, const int *b);
+
+void gmkpFreeInstance(GmkpInstance &instance);
+
+void gmkpInitOptions(GmkpOptions &options);
+
+// solve the instance, result is allocated here and released by gmkpFreeResult; returns result.error
+int gmkpSolve(const GmkpInstance &instance, const GmkpOptions &options, GmkpResult &result);
+
+void gmkpFreeResult(GmkpResult &result);
+
+const char *gmkpErrorString(int error);
+
+#endif /* GMKP_H_ */
@@ -0,0 +1,254 @@
+#include "BATCH.h"
+
+// one instance through the stages
+struct BatchJob {
+	int index;
+	int n;
+	int m;
+	int r;
+	int *b;
+	int *profits;
+	int *weights;
+	int *capacities;
+	int *setups;
+	int *classes;
+	int *indexes;
+	Model model;
+	bool built; // model opened (closed by the solve stage)
+	int status; // 0 or the GMKP_ERROR code of the parse, of the build or of the solve
+	double parseTime;
+	double buildTime;
+	double solveTime;
+	double queued; // wall clock when pushed to the last queue
+	double waitTime; // time spent in the queues
+};
+
+struct BatchResult {
+	int status;
+	double objval;
+	bool feasible;
+	double parseTime;
+	double buildTime;
+	double solveTime;
+	double waitTime;
+};
+
+// blocking queue of at most capacity jobs, closed when the last producer is done
+struct BatchQueue {
+	std::deque<BatchJob *> jobs;
+	size_t capacity;
+	int producers; // producers still running
+	std::mutex mutex;
+	std::condition_variable notFull;
+	std::condition_variable notEmpty;
+};
+
+void pushJob(BatchQueue &queue, BatchJob *job) {
+	std::unique_lock<std::mutex> lock(queue.mutex);
+	queue.notFull.wait(lock, [&] { return queue.jobs.size() < queue.capacity; });
+	job->queued = wallClock();
+	queue.jobs.push_back(job);
+	queue.notEmpty.notify_one();
+}
+
+// NULL when the queue is empty and closed
+BatchJob *popJob(BatchQueue &queue) {
+	std::unique_lock<std::mutex> lock(queue.mutex);
+	queue.notEmpty.wait(lock, [&] { return !queue.jobs.empty() || queue.producers == 0; });
+	if (queue.jobs.empty())
+		return NULL;
+	BatchJob *job = queue.jobs.front();
+	queue.jobs.pop_front();
+	job->waitTime += wallClock() - job->queued;
+	queue.notFull.notify_one();
+	return job;
+}
+
+void producerDone(BatchQueue &queue) {
+	std::lock_guard<std::mutex> lock(queue.mutex);
+	if (--queue.producers == 0)
+		queue.notEmpty.notify_all();
+}
+
+void freeInstance(BatchJob *job) {
+	free(job->b);
+	free(job->profits);
+	free(job->weights);
+	free(job->capacities);
+	free(job->setups);
+	free(job->classes);
+	free(job->indexes);
+	job->b = job->profits = job->weights = job->capacities = job->setups = job->classes = job->indexes = NULL;
+}
+
+void initBatchParameters(BatchParameters &params) {
+	params.parsers = 1;
+	params.builders = 1;
+	params.solvers = 1;
+	params.queueSize = 2;
+	params.timeLimit = 10;
+	params.exactSubproblems = true;
+	params.resultFilename = NULL;
+}
+
+int listInstances(const char *directory, std::vector<std::string> &names) {
+	std::string path = std::string("./instances/") + directory;
+	DIR *dir = opendir(path.c_str());
+	if (dir == NULL)
+		return 1;
+
+	struct dirent *entry;
+	while ((entry = readdir(dir)) != NULL) {
+		std::string name = entry->d_name;
+		if (name.size() < 5)
+			continue;
+		std::string extension = name.substr(name.size() - 4);
+		if (extension != ".inc" && extension != ".bin")
+			continue;
+		struct stat info;
+		if (stat((path + "/" + name).c_str(), &info) != 0 || !S_ISREG(info.st_mode))
+			continue;
+		names.push_back(strcmp(directory, ".") == 0 ? name : std::string(directory) + "/" + name);
+	}
+	closedir(dir);
+
+	std::sort(names.begin(), names.end());
+	return 0;
+}
+
+int runBatch(BatchParameters &params, const std::vector<std::string> &names) {
+
+	int count = (int)names.size();
+	int parsers = std::max(1, params.parsers);
+	int builders = std::max(1, params.builders);
+	int solvers = std::max(1, params.solvers);
+
+	BatchQueue parsed;
+	parsed.capacity = std::max(1, params.queueSize);
+	parsed.producers = parsers;
+	BatchQueue built;
+	built.capacity = parsed.capacity;
+	built.producers = builders;
+
+	std::vector<BatchResult> results(count);
+	std::atomic<int> next(0);
+	std::atomic<int> errors(0);
+	std::mutex outputMutex;
+	double start = wallClock();
+
+	// parse stage: the files in order, read ahead up to the queue size
+	auto parse = [&]() {
+		int index;
+		while ((index = next.fetch_add(1)) < count) {
+			BatchJob *job = new BatchJob();
+			job->index = index;
+			std::vector<char> name(names[index].begin(), names[index].end());
+			name.push_back('\0');
+			double t = wallClock();
+			job->status = readInstance(name.data(), job->n, job->m, job->r, job->weights, job->capacities, job->profits, job->classes, job->indexes, job->setups, job->b) ? GMKP_ERROR_INSTANCE : 0;
+			job->parseTime = wallClock() - t;
+			pushJob(parsed, job);
+		}
+		producerDone(parsed);
+	};
+
+	// build stage: the model of each instance with its own environment (the solve stage uses it in another thread)
+	auto build = [&]() {
+		BatchJob *job;
+		while ((job = popJob(parsed)) != NULL) {
+			if (job->status == 0) {
+				double t = wallClock();
+				job->status = openModel(job->model, NULL, job->n, job->m, job->r, job->b, job->weights, job->profits, job->capacities, job->setups, job->classes, job->indexes);
+				job->buildTime = wallClock() - t;
+				job->built = true;
+			}
+			// the model keeps its own copy of the instance
+			freeInstance(job);
+			pushJob(built, job);
+		}
+		producerDone(built);
+	};
+
+	// solve stage: the dive on the kept model, then the model is closed
+	auto solveStage = [&]() {
+		BatchJob *job;
+		while ((job = popJob(built)) != NULL) {
+			BatchResult &result = results[job->index];
+			result.objval = 0;
+			result.feasible = false;
+			if (job->status == 0) {
+				Solution solution;
+				initSolution(solution, job->n, job->m, job->r);
+
+				SolveParameters solveParams;
+				initSolveParameters(solveParams);
+				solveParams.verbose = false;
+				solveParams.exactSubproblems = params.exactSubproblems;
+				solveParams.timeLimit = params.timeLimit;
+				solveParams.TL = (int)ceil(params.timeLimit);
+
+				double t = wallClock();
+				job->status = solveModel(job->model, solveParams, solution);
+				job->solveTime = wallClock() - t;
+				result.objval = solution.objval;
+				result.feasible = solution.status == 0;
+				freeSolution(solution);
+			}
+			if (job->built)
+				closeModel(job->model);
+
+			result.status = job->status;
+			result.parseTime = job->parseTime;
+			result.buildTime = job->buildTime;
+			result.solveTime = job->solveTime;
+			result.waitTime = job->waitTime;
+			if (job->status)
+				errors++;
+
+			{
+				std::lock_guard<std::mutex> lock(outputMutex);
+				std::cout << names[job->index] << ": ";
+				if (job->status)
+					std::cout << "error " << job->status << " (" << gmkpErrorString(job->status) << ")";
+				else
+					std::cout << result.objval << (result.feasible ? " (feasible)" : " (not feasible)");
+				std::cout << ", parse " << result.parseTime << ", build " << result.buildTime << ", solve " << result.solveTime << ", queued " << result.waitTime << std::endl;
+			}
+			delete job;
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (int t = 0; t < parsers; t++)
+		threads.push_back(std::thread(parse));
+	for (int t = 0; t < builders; t++)
+		threads.push_back(std::thread(build));
+	for (int t = 0; t < solvers; t++)
+		threads.push_back(std::thread(solveStage));
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+
+	double total = wallClock() - start;
+	double parseTotal = 0, buildTotal = 0, solveTotal = 0;
+	for (int c = 0; c < count; c++) {
+		parseTotal += results[c].parseTime;
+		buildTotal += results[c].buildTime;
+		solveTotal += results[c].solveTime;
+	}
+	std::cout << "Batch: " << count << " instances, " << errors << " errors, wall time " << total << " (parse " << parseTotal << ", build " << buildTotal << ", solve " << solveTotal << " in total)" << std::endl;
+
+	if (params.resultFilename != NULL) {
+		std::ofstream file(params.resultFilename);
+		if (!file.is_open()) {
+			std::cout << "Results not written: " << params.resultFilename << std::endl;
+		}
+		else {
+			file.precision(10);
+			file << "instance,status,objval,feasible,parse,build,solve,queued" << std::endl;
+			for (int c = 0; c < count; c++)
+				file << names[c] << "," << results[c].status << "," << results[c].objval << "," << (results[c].feasible ? 1 : 0) << "," << results[c].parseTime << "," << results[c].buildTime << "," << results[c].solveTime << "," << results[c].waitTime << std::endl;
+		}
+	}
+
+	return errors;
+}
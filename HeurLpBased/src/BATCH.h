@@ -0,0 +1,46 @@
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include "INSTANCE.h"
+#include "MODEL.h"
+
+#ifndef BATCH_H_
+#define BATCH_H_
+
+/* pipeline of three stages, each one with its own threads:
+ * parse (readInstance of the next file) -> build (openModel, with its own CPLEX environment) -> solve (solveModel)
+ * the stages are linked by queues of at most queueSize instances: a stage waits when the next queue is full,
+ * so at most parsers + builders + solvers + 2 * queueSize instances are in memory
+ * */
+struct BatchParameters {
+	int parsers; // threads of the parse stage
+	int builders; // threads of the build stage
+	int solvers; // threads of the solve stage
+	int queueSize; // instances waiting between two stages at most
+	double timeLimit; // time limit of each instance (seconds, 0: none)
+	bool exactSubproblems;
+	const char *resultFilename; // csv with one line for each instance, in the order of the names (NULL: not written)
+};
+
+void initBatchParameters(BatchParameters &params);
+
+// names of the .inc and .bin files of ./instances/directory, sorted, as given to readInstance ("directory/name")
+int listInstances(const char *directory, std::vector<std::string> &names);
+
+// solve the instances through the pipeline; returns the number of instances with an error
+int runBatch(BatchParameters &params, const std::vector<std::string> &names);
+
+#endif /* BATCH_H_ */
@@ -0,0 +1,205 @@
+#include "BENCH.h"
+
+// instance of the corpus: the same name always gives the same instance
+struct BenchInstance {
+	const char *name;
+	int n;
+	int m;
+	int r;
+	unsigned long long seed;
+	int classDistribution;
+	int profitCorrelation;
+	int size;
+};
+
+const BenchInstance BENCH_CORPUS[] = {
+	{"small_1", 60, 3, 6, 1, CLASSES_UNIFORM, PROFITS_UNCORRELATED, BENCH_SMALL},
+	{"small_2", 120, 5, 10, 2, CLASSES_RANDOM, PROFITS_WEAKLY_CORRELATED, BENCH_SMALL},
+	{"small_3", 200, 4, 12, 3, CLASSES_SKEWED, PROFITS_STRONGLY_CORRELATED, BENCH_SMALL},
+	{"medium_1", 1000, 10, 40, 11, CLASSES_UNIFORM, PROFITS_UNCORRELATED, BENCH_MEDIUM},
+	{"medium_2", 2000, 20, 50, 12, CLASSES_RANDOM, PROFITS_WEAKLY_CORRELATED, BENCH_MEDIUM},
+	{"medium_3", 5000, 8, 100, 13, CLASSES_SKEWED, PROFITS_STRONGLY_CORRELATED, BENCH_MEDIUM},
+	{"large_1", 20000, 20, 200, 21, CLASSES_UNIFORM, PROFITS_UNCORRELATED, BENCH_LARGE},
+	{"large_2", 50000, 10, 400, 22, CLASSES_RANDOM, PROFITS_WEAKLY_CORRELATED, BENCH_LARGE},
+	{"large_3", 100000, 8, 500, 23, CLASSES_SKEWED, PROFITS_STRONGLY_CORRELATED, BENCH_LARGE},
+};
+
+struct BenchRecord {
+	double objval;
+	int lps;
+	double time;
+};
+
+void initBenchParameters(BenchParameters &params) {
+	params.directory = "bench";
+	params.timeLimit = 60;
+	params.iterationLimit = 0;
+	params.maxSize = BENCH_MEDIUM;
+	params.baselineFilename = NULL;
+	params.resultFilename = NULL;
+	params.objectiveTolerance = 0.001;
+	params.lpTolerance = 0.10;
+	params.timeTolerance = 0.25;
+	params.timeSlack = 0.5;
+}
+
+int readBaseline(const char *file_name, std::map<std::string, BenchRecord> &baseline) {
+	std::ifstream file(file_name);
+	if (!file.is_open())
+		return 1;
+
+	std::string line;
+	std::getline(file, line); // header
+	while (std::getline(file, line)) {
+		std::istringstream fields(line);
+		std::string name, value;
+		BenchRecord record;
+		if (!std::getline(fields, name, ','))
+			continue;
+		if (!std::getline(fields, value, ','))
+			continue;
+		record.objval = atof(value.c_str());
+		if (!std::getline(fields, value, ','))
+			continue;
+		record.lps = atoi(value.c_str());
+		if (!std::getline(fields, value, ','))
+			continue;
+		record.time = atof(value.c_str());
+		baseline[name] = record;
+	}
+	return 0;
+}
+
+int runBench(BenchParameters &params) {
+
+	std::map<std::string, BenchRecord> baseline;
+	if (params.baselineFilename != NULL && readBaseline(params.baselineFilename, baseline)) {
+		std::cout << "Baseline not read: " << params.baselineFilename << std::endl;
+		return -1;
+	}
+
+	std::string directory = std::string("./instances/") + params.directory;
+	mkdir(directory.c_str(), 0755);
+
+	std::vector<std::string> names;
+	std::vector<BenchRecord> records;
+	std::vector<int> statuses;
+	for (size_t t = 0; t < sizeof(BENCH_CORPUS) / sizeof(BENCH_CORPUS[0]); t++) {
+		const BenchInstance &instance = BENCH_CORPUS[t];
+		if (instance.size > params.maxSize)
+			continue;
+
+		// generated only the first time
+		std::string name = std::string(params.directory) + "/" + instance.name + ".bin";
+		std::vector<char> fileName(name.begin(), name.end());
+		fileName.push_back('\0');
+		struct stat info;
+		if (stat(("./instances/" + name).c_str(), &info) != 0) {
+			GeneratorParameters generator;
+			initGeneratorParameters(generator);
+			generator.n = instance.n;
+			generator.m = instance.m;
+			generator.r = instance.r;
+			generator.seed = instance.seed;
+			generator.classDistribution = instance.classDistribution;
+			generator.profitCorrelation = instance.profitCorrelation;
+			if (generateInstance(fileName.data(), generator)) {
+				std::cout << "Instance not generated: " << name << std::endl;
+				return -1;
+			}
+		}
+
+		int n, m, r;
+		int *b = NULL, *profits = NULL, *weights = NULL, *capacities = NULL, *setups = NULL, *classes = NULL, *indexes = NULL;
+		if (readInstance(fileName.data(), n, m, r, weights, capacities, profits, classes, indexes, setups, b)) {
+			std::cout << "Instance not read: " << name << std::endl;
+			return -1;
+		}
+
+		Solution solution;
+		initSolution(solution, n, m, r);
+		SolveParameters solveParams;
+		initSolveParameters(solveParams);
+		solveParams.verbose = false;
+		solveParams.TL = params.timeLimit;
+		solveParams.timeLimit = params.timeLimit;
+		solveParams.iterationLimit = params.iterationLimit;
+		DiveStatistics stats{}; // zero if the solve fails before the dive
+		solveParams.stats = &stats;
+
+		double start = wallClock();
+		int status = solve(n, m, r, b, weights, profits, capacities, setups, classes, indexes, solveParams, solution);
+		BenchRecord record;
+		record.time = wallClock() - start;
+		record.objval = status == 0 && solution.status == 0 ? solution.objval : 0;
+		record.lps = stats.lps;
+
+		names.push_back(instance.name);
+		records.push_back(record);
+		statuses.push_back(status);
+
+		freeSolution(solution);
+		free(b);
+		free(profits);
+		free(weights);
+		free(capacities);
+		free(setups);
+		free(classes);
+		free(indexes);
+	}
+
+	// summary table: current value, then the baseline in brackets
+	int regressions = 0;
+	char line[512];
+	snprintf(line, sizeof(line), "%-10s %24s %18s %22s  %s", "instance", "objective", "LPs", "time", "verdict");
+	std::cout << line << std::endl;
+	for (size_t t = 0; t < names.size(); t++) {
+		const BenchRecord &current = records[t];
+		std::string verdict = statuses[t] ? std::string("ERROR ") + gmkpErrorString(statuses[t]) : "ok";
+		char base[3][32] = {"", "", ""};
+
+		auto found = baseline.find(names[t]);
+		if (found != baseline.end()) {
+			const BenchRecord &previous = found->second;
+			snprintf(base[0], sizeof(base[0]), "(%.0f)", previous.objval);
+			snprintf(base[1], sizeof(base[1]), "(%d)", previous.lps);
+			snprintf(base[2], sizeof(base[2]), "(%.3f)", previous.time);
+
+			std::string worse;
+			if (current.objval < previous.objval * (1 - params.objectiveTolerance) - 1e-9)
+				worse += " objective";
+			if (current.lps > previous.lps * (1 + params.lpTolerance))
+				worse += " LPs";
+			if (current.time > previous.time * (1 + params.timeTolerance) + params.timeSlack)
+				worse += " time";
+			if (!worse.empty())
+				verdict = "REGRESSION:" + worse;
+			else if (statuses[t] == 0 && current.objval > previous.objval + 1e-9)
+				verdict = "ok (better objective)";
+		}
+		else if (params.baselineFilename != NULL && statuses[t] == 0) {
+			verdict = "ok (not in the baseline)";
+		}
+		if (verdict.compare(0, 2, "ok") != 0)
+			regressions++;
+
+		snprintf(line, sizeof(line), "%-10s %12.0f %11s %8d %9s %10.3f %11s  %s", names[t].c_str(), current.objval, base[0], current.lps, base[1], current.time, base[2], verdict.c_str());
+		std::cout << line << std::endl;
+	}
+	std::cout << "Bench: " << names.size() << " instances, " << regressions << " regressions" << std::endl;
+
+	if (params.resultFilename != NULL) {
+		std::ofstream file(params.resultFilename);
+		if (!file.is_open()) {
+			std::cout << "Results not written: " << params.resultFilename << std::endl;
+		}
+		else {
+			file.precision(10);
+			file << "instance,objval,lps,time" << std::endl;
+			for (size_t t = 0; t < names.size(); t++)
+				file << names[t] << "," << records[t].objval << "," << records[t].lps << "," << records[t].time << std::endl;
+		}
+	}
+
+	return regressions;
+}
@@ -0,0 +1,46 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <map>
+#include <cstdio>
+#include <cstring>
+
+#include <sys/stat.h>
+
+#include "INSTANCE.h"
+#include "GENERATOR.h"
+#include "LPBASED_CPX.h"
+
+#ifndef BENCH_H_
+#define BENCH_H_
+
+// sizes of the instances of the corpus
+#define BENCH_SMALL 0
+#define BENCH_MEDIUM 1
+#define BENCH_LARGE 2
+
+/* regression harness: a fixed corpus of seeded instances (small, medium, large) is generated once in
+ * ./instances/directory, the dive runs on each one with the same time limit or iteration limit, and the objective,
+ * the LPs and the wall time are compared with a baseline written by a previous run (csv: instance,objval,lps,time)
+ * */
+struct BenchParameters {
+	const char *directory; // corpus in ./instances/directory
+	int timeLimit; // seconds for each instance (0: none)
+	int iterationLimit; // iterations of the dive for each instance (0: none): objective and LPs do not depend on the machine
+	int maxSize; // instances up to this size (BENCH_SMALL, BENCH_MEDIUM, BENCH_LARGE)
+	const char *baselineFilename; // NULL: no comparison
+	const char *resultFilename; // NULL: not written (same format of the baseline)
+	double objectiveTolerance; // relative loss of objective allowed
+	double lpTolerance; // relative increase of LPs allowed
+	double timeTolerance; // relative increase of wall time allowed
+	double timeSlack; // seconds of increase always allowed (noise of the short runs)
+};
+
+void initBenchParameters(BenchParameters &params);
+
+// returns the number of regressions (-1: corpus or baseline not available)
+int runBench(BenchParameters &params);
+
+#endif /* BENCH_H_ */
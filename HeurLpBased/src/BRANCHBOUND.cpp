@@ -0,0 +1,661 @@
+#include "BRANCHBOUND.h"
+
+#define BB_EPS 1e-6
+#define BB_INFINITY 1e30
+
+struct Node {
+	double bound; // LP value of the parent (upper bound of the subtree)
+	long long id;
+	int depth; // number of bound changes
+	int *changes; // index * 2 + value of each fixed variable
+};
+
+// the top of the queue is the node with the best bound, then the oldest one
+struct NodeOrder {
+	bool operator()(const Node &a, const Node &b) const {
+		if (a.bound != b.bound)
+			return a.bound < b.bound;
+		return a.id > b.id;
+	}
+};
+
+// result of the LP of a node
+struct NodeOutcome {
+	bool solved; // false if the node is pruned by the incumbent or infeasible
+	double objval;
+	int branch; // branching variable, -1 if the node has no children
+	double branchValue;
+	Solution solution; // rounding of the LP solution, status 0 if feasible
+};
+
+struct BranchAndBoundShared {
+	int n;
+	int m;
+	int r;
+	int *b;
+	int *weights;
+	int *profits;
+	int *capacities;
+	int *setups;
+	int *classes;
+	int *indexes;
+	BranchAndBoundParameters *params;
+
+	std::priority_queue<Node, std::vector<Node>, NodeOrder> queue;
+	std::mutex mutex;
+	std::condition_variable cv;
+	long long nextId;
+	long long nodes;
+	long long started; // nodes taken by the workers, solved or being solved (node limit of the parallel search)
+	long long memory; // bytes of the nodes in the queue
+	int active; // workers processing a node
+	int running; // workers not terminated
+	std::vector<double> processing; // bound of the node of each worker (-BB_INFINITY if idle)
+	double droppedBound; // best bound of the nodes dropped by the memory or the time limit
+	bool memoryLimitReached;
+	bool stop;
+	int error;
+	double start;
+	Solution *incumbent;
+
+	// deterministic mode
+	std::vector<Node> batch; // nodes of the current epoch
+	std::vector<NodeOutcome> outcomes; // outcome of each node of the batch
+	double batchBound; // best bound of the batch
+	double epochIncumbent; // incumbent at the start of the epoch
+	int nextTask;
+	int finishedTasks;
+	int opening; // workers still building their model
+	long long epoch;
+};
+
+long long nodeMemory(int depth) {
+	return (long long)(sizeof(Node) + sizeof(int) * depth);
+}
+
+Node childNode(const Node &parent, int index, int value, double bound, long long id) {
+	Node child;
+	child.bound = bound;
+	child.id = id;
+	child.depth = parent.depth + 1;
+	child.changes = new int[child.depth];
+	for (int c = 0; c < parent.depth; c++)
+		child.changes[c] = parent.changes[c];
+	child.changes[parent.depth] = index * 2 + value;
+	return child;
+}
+
+// index of the most fractional value in x[begin ... end-1], -1 if all are integer
+int mostFractional(double *x, int begin, int end) {
+	int index = -1;
+	double score = BB_EPS;
+	for (int i = begin; i < end; i++) {
+		double f = x[i] - floor(x[i]);
+		double s = f < 1 - f ? f : 1 - f;
+		if (s > score) {
+			score = s;
+			index = i;
+		}
+	}
+	return index;
+}
+
+// called with the lock
+double globalBound(BranchAndBoundShared &sh) {
+	double bound = sh.incumbent->objval;
+	if (!sh.queue.empty() && sh.queue.top().bound > bound)
+		bound = sh.queue.top().bound;
+	for (size_t w = 0; w < sh.processing.size(); w++)
+		if (sh.processing[w] > bound)
+			bound = sh.processing[w];
+	if (sh.droppedBound > bound)
+		bound = sh.droppedBound;
+	if (sh.batchBound > bound)
+		bound = sh.batchBound;
+	return bound;
+}
+
+// called with the lock
+void updateIncumbent(BranchAndBoundShared &sh, const Solution &sol) {
+	if (sol.status == 0 && sol.objval > sh.incumbent->objval) {
+		copySolution(sol, *sh.incumbent);
+		sh.incumbent->time = wallClock() - sh.start;
+	}
+}
+
+// state of a worker: its own CPLEX environment and lp, with the buffers of the node
+struct BranchAndBoundWorker {
+	CPXENVptr env;
+	CPXLPptr lp;
+	double *x;
+	double *xRounded;
+	int *indices;
+	char *lu;
+	double *bd;
+	int *cstat; // basis of the root (deterministic mode)
+	int *rstat;
+	std::vector<int> applied; // bounds changed in the lp by the previous node
+};
+
+int openWorker(BranchAndBoundShared &sh, BranchAndBoundWorker &wk) {
+	int ccnt = sh.n*sh.m + sh.m*sh.r;
+	int status;
+
+	wk.lp = NULL;
+	wk.cstat = NULL;
+	wk.rstat = NULL;
+	wk.x = new double[ccnt];
+	wk.xRounded = new double[ccnt];
+	wk.indices = new int[2 * ccnt];
+	wk.lu = new char[2 * ccnt];
+	wk.bd = new double[2 * ccnt];
+
+	wk.env = CPXopenCPLEX(&status);
+	if (status)
+		return GMKP_ERROR_ENVIRONMENT;
+	if (CPXsetintparam(wk.env, CPX_PARAM_THREADS, 1) || CPXsetintparam(wk.env, CPX_PARAM_SCRIND, CPX_OFF))
+		return GMKP_ERROR_PARAMETERS;
+	wk.lp = CPXcreateprob(wk.env, &status, "GMKP - Branch and bound");
+	if (status)
+		return GMKP_ERROR_ENVIRONMENT;
+	status = buildModel(wk.env, wk.lp, sh.n, sh.m, sh.r, sh.b, sh.weights, sh.profits, sh.capacities, sh.setups, sh.classes, sh.indexes, NULL, NULL);
+
+	/* deterministic mode: the LP of every node starts from the basis of the root,
+	 * so its solution does not depend on the nodes solved before by the same worker
+	 * */
+	if (!status && sh.params->deterministic) {
+		wk.cstat = new int[ccnt];
+		wk.rstat = new int[CPXgetnumrows(wk.env, wk.lp)];
+		if (CPXlpopt(wk.env, wk.lp) || CPXgetbase(wk.env, wk.lp, wk.cstat, wk.rstat))
+			status = GMKP_ERROR_OPTIMIZE;
+	}
+	return status;
+}
+
+void closeWorker(BranchAndBoundWorker &wk) {
+	delete[] wk.x;
+	delete[] wk.xRounded;
+	delete[] wk.indices;
+	delete[] wk.lu;
+	delete[] wk.bd;
+	delete[] wk.cstat;
+	delete[] wk.rstat;
+
+	if (wk.lp != NULL)
+		CPXfreeprob(wk.env, &wk.lp);
+	if (wk.env != NULL)
+		CPXcloseCPLEX(&wk.env);
+}
+
+/* LP of a node, rounding heuristic and choice of the branching variable
+ * the node is pruned if it cannot improve incumbentValue by 1 (profits are integer)
+ * */
+int solveNode(BranchAndBoundShared &sh, BranchAndBoundWorker &wk, const Node &node, double incumbentValue, NodeOutcome &out) {
+
+	int n = sh.n;
+	int m = sh.m;
+	int r = sh.r;
+	int ccnt = n*m + m*r;
+	int status = 0;
+
+	out.solved = false;
+	out.branch = -1;
+	out.solution.status = 1;
+
+	if (floor(node.bound + BB_EPS) <= incumbentValue)
+		return 0;
+
+	/* bounds of the node: the changes of the previous node are reset
+	 * */
+	int cnt = 0;
+	for (size_t c = 0; c < wk.applied.size(); c++) {
+		wk.indices[cnt] = wk.applied[c];
+		wk.lu[cnt] = 'L';
+		wk.bd[cnt] = 0;
+		cnt++;
+		wk.indices[cnt] = wk.applied[c];
+		wk.lu[cnt] = 'U';
+		wk.bd[cnt] = 1;
+		cnt++;
+	}
+	if (cnt > 0)
+		status = CPXchgbds(wk.env, wk.lp, cnt, wk.indices, wk.lu, wk.bd);
+
+	wk.applied.clear();
+	cnt = 0;
+	for (int c = 0; c < node.depth; c++) {
+		wk.indices[cnt] = node.changes[c] / 2;
+		wk.lu[cnt] = 'B';
+		wk.bd[cnt] = node.changes[c] % 2;
+		wk.applied.push_back(wk.indices[cnt]);
+		cnt++;
+	}
+	if (!status && cnt > 0)
+		status = CPXchgbds(wk.env, wk.lp, cnt, wk.indices, wk.lu, wk.bd);
+	if (status) {
+		std::cerr << "error: GMKP failed to change CPX bounds" << std::endl;
+		return GMKP_ERROR_BOUNDS;
+	}
+
+	// deterministic mode: same starting basis and a random seed given by the node
+	if (sh.params->deterministic) {
+		status = CPXcopybase(wk.env, wk.lp, wk.cstat, wk.rstat);
+		if (!status)
+			status = CPXsetintparam(wk.env, CPX_PARAM_RANDOMSEED, (int)(mix64(sh.params->seed ^ (unsigned long long)node.id) & 0x7FFFFFFF));
+		if (status) {
+			std::cerr << "error: GMKP failed to set the starting basis of the node" << std::endl;
+			return GMKP_ERROR_OPTIMIZE;
+		}
+	}
+
+	status = CPXlpopt(wk.env, wk.lp);
+	if (status) {
+		std::cerr << "error: GMKP failed to optimize" << std::endl;
+		return GMKP_ERROR_OPTIMIZE;
+	}
+
+	int solstat = CPXgetstat(wk.env, wk.lp);
+	out.solved = solstat != CPX_STAT_INFEASIBLE && solstat != CPX_STAT_INForUNBD
+		&& !CPXgetobjval(wk.env, wk.lp, &out.objval) && !CPXgetx(wk.env, wk.lp, wk.x, 0, ccnt - 1);
+
+	if (!out.solved || floor(out.objval + BB_EPS) <= incumbentValue) {
+		out.solved = false;
+		return 0;
+	}
+
+	// rounding heuristic
+	solutionFromX(out.solution, wk.x, sh.profits, sh.classes, sh.indexes);
+	solutionToX(out.solution, wk.xRounded);
+	out.solution.status = checkSolution(wk.xRounded, out.solution.objval, n, m, r, sh.b, sh.weights, sh.profits, sh.capacities, sh.setups, sh.classes, sh.indexes);
+	if (out.solution.status == 0 && out.solution.objval > incumbentValue)
+		incumbentValue = out.solution.objval;
+
+	// branching variable: the most fractional y, then the most fractional x
+	out.branch = mostFractional(wk.x, n*m, ccnt);
+	if (out.branch < 0)
+		out.branch = mostFractional(wk.x, 0, n*m);
+	if (out.branch >= 0) {
+		out.branchValue = wk.x[out.branch];
+		if (floor(out.objval + BB_EPS) <= incumbentValue)
+			out.branch = -1;
+	}
+	return 0;
+}
+
+void branchAndBoundWorker(BranchAndBoundShared &sh, int worker) {
+
+	BranchAndBoundWorker wk;
+	int status = openWorker(sh, wk);
+
+	NodeOutcome out;
+	initSolution(out.solution, sh.n, sh.m, sh.r);
+
+	Node node;
+	bool plunge = false; // the next node is a child kept by the worker (memory limit)
+	double incumbentValue = 0;
+
+	if (status) {
+		std::cerr << "error: GMKP branch and bound failed to build the model" << std::endl;
+		std::lock_guard<std::mutex> lock(sh.mutex);
+		sh.error = status;
+		sh.stop = true;
+	}
+
+	while (!status) {
+
+		if (!plunge) {
+			std::unique_lock<std::mutex> lock(sh.mutex);
+			sh.cv.wait(lock, [&] { return sh.stop || !sh.queue.empty() || sh.active == 0; });
+			if (sh.stop || sh.queue.empty())
+				break;
+
+			node = sh.queue.top();
+			sh.queue.pop();
+			sh.memory -= nodeMemory(node.depth);
+			sh.active++;
+			sh.processing[worker] = node.bound;
+			incumbentValue = sh.incumbent->objval;
+		}
+		plunge = false;
+
+		bool branched = false;
+		Node keep;
+
+		bool limitReached;
+		{
+			// time or node limit: the node is not explored, its bound is still open
+			std::lock_guard<std::mutex> lock(sh.mutex);
+			limitReached = wallClock() - sh.start > sh.params->timeLimit || (sh.params->nodeLimit >= 0 && sh.started >= sh.params->nodeLimit);
+			if (limitReached) {
+				sh.stop = true;
+				if (node.bound > sh.droppedBound)
+					sh.droppedBound = node.bound;
+				sh.active--;
+				sh.processing[worker] = -BB_INFINITY;
+			}
+			else {
+				sh.started++;
+			}
+		}
+		if (limitReached) {
+			delete[] node.changes;
+			break;
+		}
+
+		status = solveNode(sh, wk, node, incumbentValue, out);
+		if (status) {
+			std::lock_guard<std::mutex> lock(sh.mutex);
+			sh.error = status;
+			sh.stop = true;
+			sh.active--;
+			sh.processing[worker] = -BB_INFINITY;
+			delete[] node.changes;
+			break;
+		}
+
+		if (out.solved) {
+			std::lock_guard<std::mutex> lock(sh.mutex);
+			updateIncumbent(sh, out.solution);
+			incumbentValue = sh.incumbent->objval;
+
+			if (out.branch >= 0 && floor(out.objval + BB_EPS) > incumbentValue) {
+				Node up = childNode(node, out.branch, 1, out.objval, sh.nextId++);
+				Node down = childNode(node, out.branch, 0, out.objval, sh.nextId++);
+				long long size = nodeMemory(up.depth);
+
+				if (sh.memory + 2 * size <= sh.params->memoryLimit) {
+					sh.queue.push(up);
+					sh.queue.push(down);
+					sh.memory += 2 * size;
+				}
+				else {
+					// depth first on the child closer to the LP value, the other one is kept only if there is memory
+					sh.memoryLimitReached = true;
+					keep = out.branchValue >= 0.5 ? up : down;
+					Node other = out.branchValue >= 0.5 ? down : up;
+					if (sh.memory + size <= sh.params->memoryLimit) {
+						sh.queue.push(other);
+						sh.memory += size;
+					}
+					else {
+						if (other.bound > sh.droppedBound)
+							sh.droppedBound = other.bound;
+						delete[] other.changes;
+					}
+					branched = true;
+				}
+			}
+		}
+
+		delete[] node.changes;
+
+		std::lock_guard<std::mutex> lock(sh.mutex);
+		sh.nodes++;
+		if (branched) {
+			node = keep;
+			plunge = true;
+			sh.processing[worker] = node.bound;
+			incumbentValue = sh.incumbent->objval;
+		}
+		else {
+			sh.active--;
+			sh.processing[worker] = -BB_INFINITY;
+		}
+		sh.cv.notify_all();
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(sh.mutex);
+		sh.running--;
+		sh.cv.notify_all();
+	}
+
+	freeSolution(out.solution);
+	closeWorker(wk);
+}
+
+/* end of an epoch of the deterministic mode (called with the lock by the worker that solved the last node of the batch)
+ * the outcomes are merged in the order of the batch, so the result does not depend on which worker solved each node:
+ * the incumbent is replaced only by a strictly better solution (the first one in the batch wins the ties),
+ * the children get their ids in the same order and the next batch is made of the best nodes of the queue
+ * */
+void closeEpoch(BranchAndBoundShared &sh) {
+
+	for (size_t k = 0; k < sh.batch.size(); k++)
+		if (sh.outcomes[k].solved)
+			updateIncumbent(sh, sh.outcomes[k].solution);
+
+	double incumbentValue = sh.incumbent->objval;
+	for (size_t k = 0; k < sh.batch.size(); k++) {
+		NodeOutcome &out = sh.outcomes[k];
+		if (out.solved && out.branch >= 0 && floor(out.objval + BB_EPS) > incumbentValue) {
+			Node up = childNode(sh.batch[k], out.branch, 1, out.objval, sh.nextId++);
+			Node down = childNode(sh.batch[k], out.branch, 0, out.objval, sh.nextId++);
+			long long size = nodeMemory(up.depth);
+			if (sh.memory + 2 * size <= sh.params->memoryLimit) {
+				sh.queue.push(up);
+				sh.queue.push(down);
+				sh.memory += 2 * size;
+			}
+			else {
+				// no plunging here: it would depend on the worker, the children are dropped and their bound is kept
+				sh.memoryLimitReached = true;
+				if (out.objval > sh.droppedBound)
+					sh.droppedBound = out.objval;
+				delete[] up.changes;
+				delete[] down.changes;
+			}
+		}
+		delete[] sh.batch[k].changes;
+	}
+	sh.nodes += (long long)sh.batch.size();
+	sh.batch.clear();
+	sh.batchBound = -BB_INFINITY;
+
+	// the time limit is checked only here: a run stopped by the time is a prefix of the same sequence of epochs
+	if (wallClock() - sh.start > sh.params->timeLimit || (sh.params->nodeLimit >= 0 && sh.nodes >= sh.params->nodeLimit))
+		sh.stop = true;
+
+	while (!sh.stop && !sh.queue.empty() && (int)sh.batch.size() < sh.params->batchSize) {
+		Node node = sh.queue.top();
+		sh.queue.pop();
+		sh.memory -= nodeMemory(node.depth);
+		if (node.bound > sh.batchBound)
+			sh.batchBound = node.bound;
+		sh.batch.push_back(node);
+	}
+	if (sh.batch.empty())
+		sh.stop = true;
+
+	sh.nextTask = 0;
+	sh.finishedTasks = 0;
+	sh.epochIncumbent = sh.incumbent->objval;
+	sh.epoch++;
+	sh.cv.notify_all();
+}
+
+// same signature of branchAndBoundWorker: the index of the worker is not used, nothing may depend on it
+void deterministicWorker(BranchAndBoundShared &sh, int) {
+
+	BranchAndBoundWorker wk;
+	int status = openWorker(sh, wk);
+	long long epoch = -1;
+
+	if (status)
+		std::cerr << "error: GMKP branch and bound failed to build the model" << std::endl;
+
+	std::unique_lock<std::mutex> lock(sh.mutex);
+	sh.error = sh.error ? sh.error : status;
+	if (--sh.opening == 0) {
+		if (sh.error)
+			sh.stop = true;
+		closeEpoch(sh);
+	}
+
+	while (true) {
+		sh.cv.wait(lock, [&] { return sh.stop || sh.epoch != epoch; });
+		if (sh.stop)
+			break;
+		epoch = sh.epoch;
+
+		// the nodes of the batch are taken in any order, the outcome of each one is stored at its index
+		while (sh.nextTask < (int)sh.batch.size()) {
+			int k = sh.nextTask++;
+			const Node &node = sh.batch[k];
+			double incumbentValue = sh.epochIncumbent;
+			lock.unlock();
+
+			status = solveNode(sh, wk, node, incumbentValue, sh.outcomes[k]);
+
+			lock.lock();
+			if (status) {
+				sh.error = status;
+				sh.stop = true;
+			}
+			if (++sh.finishedTasks == (int)sh.batch.size())
+				closeEpoch(sh);
+		}
+	}
+
+	sh.running--;
+	sh.cv.notify_all();
+	lock.unlock();
+
+	closeWorker(wk);
+}
+
+void initBranchAndBoundParameters(BranchAndBoundParameters &params) {
+	params.timeLimit = 60;
+	params.threads = 1;
+	params.memoryLimit = 1LL << 30;
+	params.logInterval = 1;
+	params.deterministic = false;
+	params.batchSize = 16;
+	params.seed = 50321;
+	params.nodeLimit = -1;
+	params.verbose = true;
+}
+
+int branchAndBound(int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, BranchAndBoundParameters &params, Solution &incumbent, BranchAndBoundResult &result, RunReport * report) {
+
+	BranchAndBoundShared sh;
+	sh.n = n;
+	sh.m = m;
+	sh.r = r;
+	sh.b = b;
+	sh.weights = weights;
+	sh.profits = profits;
+	sh.capacities = capacities;
+	sh.setups = setups;
+	sh.classes = classes;
+	sh.indexes = indexes;
+	sh.params = &params;
+	sh.nextId = 0;
+	sh.nodes = 0;
+	sh.started = 0;
+	sh.memory = 0;
+	sh.active = 0;
+	sh.running = params.threads > 0 ? params.threads : 1;
+	sh.processing.assign(sh.running, -BB_INFINITY);
+	sh.droppedBound = -BB_INFINITY;
+	sh.memoryLimitReached = false;
+	sh.stop = false;
+	sh.error = 0;
+	sh.start = wallClock();
+	sh.incumbent = &incumbent;
+	sh.batchBound = -BB_INFINITY;
+	sh.epochIncumbent = 0;
+	sh.nextTask = 0;
+	sh.finishedTasks = 0;
+	sh.opening = sh.running;
+	sh.epoch = 0;
+
+	// the empty assignment is always feasible
+	if (incumbent.status != 0) {
+		for (int j = 0; j < n; j++)
+			incumbent.itemKnapsack[j] = -1;
+		memset(incumbent.openClasses, 0, sizeof(char) * m * r);
+		incumbent.objval = 0;
+		incumbent.status = 0;
+	}
+
+	// root: bound given by the best knapsack of each item
+	Node root;
+	root.bound = 0;
+	for (int j = 0; j < n; j++) {
+		int best = 0;
+		for (int i = 0; i < m; i++)
+			if (profits[i*n + j] > best)
+				best = profits[i*n + j];
+		root.bound += best;
+	}
+	root.id = sh.nextId++;
+	root.depth = 0;
+	root.changes = NULL;
+	sh.queue.push(root);
+	sh.memory = nodeMemory(0);
+
+	if (params.deterministic) {
+		if (params.batchSize < 1)
+			params.batchSize = 1;
+		sh.outcomes.resize(params.batchSize);
+		for (int k = 0; k < params.batchSize; k++)
+			initSolution(sh.outcomes[k].solution, n, m, r);
+	}
+
+	std::vector<std::thread> workers;
+	for (int w = 0; w < sh.running; w++)
+		workers.push_back(std::thread(params.deterministic ? deterministicWorker : branchAndBoundWorker, std::ref(sh), w));
+
+	if (params.verbose)
+		std::cout << "B&B\ttime\tnodes\topen\tincumbent\tbound\tgap" << std::endl;
+
+	// progress of the search
+	bool finished = false;
+	while (!finished) {
+		TraceBranchAndBound progress;
+		{
+			std::unique_lock<std::mutex> lock(sh.mutex);
+			sh.cv.wait_for(lock, std::chrono::duration<double>(params.logInterval), [&] { return sh.running == 0; });
+			finished = sh.running == 0;
+
+			progress.time = wallClock() - sh.start;
+			progress.nodes = sh.nodes;
+			progress.openNodes = (long long)sh.queue.size();
+			progress.incumbent = incumbent.objval;
+			progress.bound = globalBound(sh);
+			progress.gap = progress.bound > 0 ? (progress.bound - progress.incumbent) / progress.bound : 0;
+		}
+
+		if (params.verbose)
+			std::cout << "B&B\t" << progress.time << "\t" << progress.nodes << "\t" << progress.openNodes << "\t" << progress.incumbent << "\t" << progress.bound << "\t" << progress.gap * 100 << "%" << std::endl;
+		if (report != NULL)
+			report->branchAndBound(progress);
+	}
+
+	for (size_t w = 0; w < workers.size(); w++)
+		workers[w].join();
+
+	result.incumbent = incumbent.objval;
+	result.bound = globalBound(sh);
+	// integer objective: a bound smaller than incumbent + 1 proves optimality
+	if (floor(result.bound + BB_EPS) <= result.incumbent)
+		result.bound = result.incumbent;
+	result.gap = result.bound > 0 ? (result.bound - result.incumbent) / result.bound : 0;
+	result.nodes = sh.nodes;
+	result.openNodes = (long long)(sh.queue.size() + sh.batch.size());
+	result.optimal = result.bound == result.incumbent;
+	result.memoryLimitReached = sh.memoryLimitReached;
+	result.time = wallClock() - sh.start;
+
+	while (!sh.queue.empty()) {
+		delete[] sh.queue.top().changes;
+		sh.queue.pop();
+	}
+	for (size_t k = 0; k < sh.batch.size(); k++)
+		delete[] sh.batch[k].changes;
+	for (size_t k = 0; k < sh.outcomes.size(); k++)
+		freeSolution(sh.outcomes[k].solution);
+
+	return sh.error;
+}
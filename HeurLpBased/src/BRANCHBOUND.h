@@ -0,0 +1,52 @@
+#include <vector>
+#include <queue>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cmath>
+#include <chrono>
+
+#include "LPBASED_CPX.h"
+
+#ifndef BRANCHBOUND_H_
+#define BRANCHBOUND_H_
+
+struct BranchAndBoundParameters {
+	double timeLimit; // seconds
+	int threads; // each thread has its own CPLEX environment and lp
+	long long memoryLimit; // bytes used by the open nodes
+	double logInterval; // seconds between two progress lines
+	bool deterministic; // same result for any number of threads (nodes solved in batches, see below)
+	int batchSize; // nodes of each epoch in the deterministic mode
+	unsigned long long seed; // random seed of the LPs, combined with the id of each node
+	long long nodeLimit; // nodes solved at most (-1: no limit)
+	bool verbose; // progress lines on the standard output
+};
+
+struct BranchAndBoundResult {
+	double incumbent;
+	double bound; // upper bound of the optimal value
+	double gap; // (bound - incumbent) / bound
+	long long nodes; // nodes solved
+	long long openNodes; // nodes not explored (time limit)
+	bool optimal;
+	bool memoryLimitReached; // some nodes were dropped: the bound includes their LP value
+	double time;
+};
+
+void initBranchAndBoundParameters(BranchAndBoundParameters &params);
+
+// bytes of an open node with depth bound changes (counted against memoryLimit)
+long long nodeMemory(int depth);
+
+/* best-bound branch and bound on the model of solve(): branching on the most fractional y first, then on x
+ * a node stores only the bounds changed from the root (index * 2 + value, 4 bytes each)
+ * incumbent is the starting solution (e.g. the solution of the dive) and it is replaced by the better ones
+ * deterministic mode: the search is a sequence of epochs, each one solving the batchSize best open nodes in parallel;
+ * every LP starts from the root basis with a seed given by the node, and the outcomes are merged at the end of the
+ * epoch in the order of the batch, so that nodes, incumbent and bound depend neither on the threads nor on the timing
+ * (with a time limit the run stops at the end of an epoch)
+ * */
+int branchAndBound(int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, BranchAndBoundParameters &params, Solution &incumbent, BranchAndBoundResult &result, RunReport * report);
+
+#endif /* BRANCHBOUND_H_ */
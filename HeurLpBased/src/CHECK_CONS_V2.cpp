@@ -26,36 +26,15 @@ int checkSolution(double *x, double objval, int n, int m, int r, int * b, int *
 			return 1;
 	}
 
-	// constraint 2
-	for (int j = 0; j < n; j++) {
-
-		sum = 0;
-
-		for (int i = 0; i < m; i++) {
-			sum += x[i*n + j];
-		}
-
-		//std::cout << "ITEM" << j + 1 << " " << sum << " " << std::endl;
+	const Kernels &kernels = selectKernels(m);
 
-		if (sum > 1)
-			return 2;
-	}
+	// constraint 2
+	if (kernels.itemAssignments(x, n, m, 0, n) >= 0)
+		return 2;
 
 	// check constraint 3
-	for (int k = 0; k < r; k++)
-	{
-		sum = 0;
-
-		for (int i = 0; i < m; i++)
-		{
-			sum += x[m*n + i * r + k];
-		}
-
-		//std::cout << "BIN" << k + 1 << " " << sum << std::endl;
-
-		if (sum > b[k])
-			return 3;
-	}
+	if (kernels.classOpenings(x, n, m, r, b) >= 0)
+		return 3;
 
 	// check constraint 4
 	sum = 0;
@@ -84,4 +63,58 @@ int checkSolution(double *x, double objval, int n, int m, int r, int * b, int *
 
 	// if solution is ok
 	return 0;
-}
\ No newline at end of file
+}
+
+int checkSolutionParallel(const ParallelPlan *plan, double *x, double objval, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes) {
+
+	if (plan == NULL || plan->threads <= 1)
+		return checkSolution(x, objval, n, m, r, b, weights, profits, capacities, setups, classes, indexes);
+
+	std::atomic<bool> violated(false);
+	const Kernels &kernels = selectKernels(m);
+
+	// check constraint 1, in blocks of knapsacks
+	parallelBlocks(plan, m, n + r, [&](int, long long begin, long long end) {
+		for (long long i = begin; i < end && !violated; i++) {
+			int sum = 0;
+			for (int j = 0; j < n; j++)
+				sum += x[i*n + j] * weights[j];
+			for (int k = 0; k < r; k++)
+				sum += x[m*n + i * r + k] * setups[k];
+			if (sum > capacities[i])
+				violated = true;
+		}
+	});
+	if (violated)
+		return 1;
+
+	// constraint 2, in blocks of items
+	parallelBlocks(plan, n, m, [&](int, long long begin, long long end) {
+		if (kernels.itemAssignments(x, n, m, begin, end) >= 0)
+			violated = true;
+	});
+	if (violated)
+		return 2;
+
+	// check constraint 3
+	if (kernels.classOpenings(x, n, m, r, b) >= 0)
+		return 3;
+
+	// check constraint 4: the item at the position z of classes is in the class k
+	parallelBlocks(plan, n, m, [&](int, long long begin, long long end) {
+		int k = (int)(std::upper_bound(indexes, indexes + r, (int)begin) - indexes);
+		for (long long z = begin; z < end && !violated; z++) {
+			while (z >= indexes[k])
+				k++;
+			for (int i = 0; i < m; i++) {
+				int sum = x[n * i + classes[z]] - x[n * m + i * r + k];
+				if (sum > 0 && x[m*n + i * r + k] == 0)
+					violated = true;
+			}
+		}
+	});
+	if (violated)
+		return 4;
+
+	return 0;
+}
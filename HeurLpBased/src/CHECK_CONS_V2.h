@@ -1,6 +1,16 @@
+#include <atomic>
+
+#include "PARALLEL.h"
+#include "KERNELS.h"
+
 #ifndef CHECK_CONS_V2_H_
 #define CHECK_CONS_V2_H_
 
 int checkSolution(double *x, double objval, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes);
 
+/* same result of checkSolution with the threads of plan: constraints (1) in blocks of knapsacks,
+ * (2) and (4) in blocks of items; each constraint is checked as in checkSolution (NULL: checkSolution)
+ * */
+int checkSolutionParallel(const ParallelPlan *plan, double *x, double objval, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes);
+
 #endif /* CHECK_CONS_V2_H_ */
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "COLUMNS.h"
+
+// column of the lp of the x of full index f, -1 if it is not in the lp
+int lpColumn(const ColumnSet &cols, int f) {
+	auto found = cols.lpIndex.find(f);
+	return found != cols.lpIndex.end() ? found->second : -1;
+}
+
+int buildRestrictedModel(CPXENVptr env, CPXLPptr lp, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, int columnsPerClass, int batch, ColumnSet &cols) {
+
+	int status;
+
+	cols.n = n;
+	cols.m = m;
+	cols.r = r;
+	cols.weights = weights;
+	cols.profits = profits;
+	cols.classes = classes;
+	cols.indexes = indexes;
+	cols.itemClass.resize(n);
+	computeItemClass(n, r, classes, indexes, cols.itemClass.data());
+	cols.lpIndex.clear();
+	cols.fullIndex.clear();
+	cols.fixedZero.clear();
+	cols.batch = batch > 0 ? batch : n;
+	cols.rounds = 0;
+
+	status = CPXchgobjsen(env, lp, CPX_MAX);
+	if (status) {
+		std::cerr << "error: GMKP CPXchgobjsen failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+
+	// columns y(i,k)
+	std::vector<double> obj(m*r, 0.0);
+	std::vector<double> lb(m*r, 0.0);
+	std::vector<double> ub(m*r, 1.0);
+	status = CPXnewcols(env, lp, m*r, obj.data(), lb.data(), ub.data(), NULL, NULL);
+	if (status) {
+		std::cerr << "error: GMKP CPXnewcols failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+	for (int c = 0; c < m*r; c++)
+		cols.fullIndex.push_back(n*m + c);
+
+	// constraint (1) with the y only: \sum_{k = 1 ... r} s_k * y_ik <= C_i
+	std::vector<int> rmatbeg(m);
+	std::vector<double> rhs(m);
+	std::vector<char> sense(m, 'L');
+	std::vector<int> rmatind(m*r);
+	std::vector<double> rmatval(m*r);
+	for (int i = 0; i < m; i++) {
+		rmatbeg[i] = i * r;
+		rhs[i] = capacities[i];
+		for (int k = 0; k < r; k++) {
+			rmatind[i*r + k] = i*r + k;
+			rmatval[i*r + k] = setups[k];
+		}
+	}
+	status = CPXaddrows(env, lp, 0, m, m*r, rhs.data(), sense.data(), rmatbeg.data(), rmatind.data(), rmatval.data(), NULL, NULL);
+	if (status) {
+		std::cerr << "error: GMKP CPXaddrows (1-th constraint) failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+
+	// constraint (2) without coefficients: they come with the x
+	std::vector<double> ones(n, 1.0);
+	std::vector<char> senseItems(n, 'L');
+	status = CPXnewrows(env, lp, n, ones.data(), senseItems.data(), NULL, NULL);
+	if (status) {
+		std::cerr << "error: GMKP CPXnewrows (2-nd constraint) failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+
+	// constraint (3): \sum_{i = 1 ... m} y_ik <= b_k
+	rmatbeg.resize(r);
+	rhs.resize(r);
+	sense.assign(r, 'L');
+	for (int k = 0; k < r; k++) {
+		rmatbeg[k] = k * m;
+		rhs[k] = b[k];
+		for (int i = 0; i < m; i++) {
+			rmatind[k*m + i] = i*r + k;
+			rmatval[k*m + i] = 1.0;
+		}
+	}
+	status = CPXaddrows(env, lp, 0, r, m*r, rhs.data(), sense.data(), rmatbeg.data(), rmatind.data(), rmatval.data(), NULL, NULL);
+	if (status) {
+		std::cerr << "error: GMKP CPXaddrows (3-rd constraint) failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+
+	// starting columns: the best p(i,j)/w(j) of each class in each knapsack
+	std::vector<int> start;
+	std::vector<std::pair<double, int>> ratio;
+	for (int k = 0; k < r; k++) {
+		int indexes_prev = k > 0 ? indexes[k - 1] : 0;
+		int size = indexes[k] - indexes_prev;
+		int count = std::min(columnsPerClass, size);
+		for (int i = 0; i < m; i++) {
+			ratio.clear();
+			for (int z = indexes_prev; z < indexes[k]; z++) {
+				int j = classes[z];
+				ratio.push_back(std::make_pair(-(double)profits[i*n + j] / (weights[j] > 0 ? weights[j] : 1), j));
+			}
+			std::nth_element(ratio.begin(), ratio.begin() + (count - 1), ratio.end());
+			for (int c = 0; c < count; c++)
+				start.push_back(i*n + ratio[c].second);
+		}
+	}
+	std::sort(start.begin(), start.end());
+
+	return addColumns(env, lp, cols, (int)start.size(), start.data());
+}
+
+int addColumns(CPXENVptr env, CPXLPptr lp, ColumnSet &cols, int count, const int *indices) {
+
+	int n = cols.n;
+	int m = cols.m;
+	int r = cols.r;
+	if (count == 0)
+		return 0;
+
+	// x(i,j): w_j in the row (1) of i, 1 in the row (2) of j
+	int first = CPXgetnumcols(env, lp);
+	std::vector<double> obj(count);
+	std::vector<double> lb(count, 0.0);
+	std::vector<double> ub(count, 1.0);
+	std::vector<int> cmatbeg(count);
+	std::vector<int> cmatind(2 * count);
+	std::vector<double> cmatval(2 * count);
+	for (int c = 0; c < count; c++) {
+		int i = indices[c] / n;
+		int j = indices[c] % n;
+		obj[c] = cols.profits[indices[c]];
+		ub[c] = cols.fixedZero.count(indices[c]) ? 0.0 : 1.0;
+		cmatbeg[c] = 2 * c;
+		cmatind[2*c] = i;
+		cmatval[2*c] = cols.weights[j];
+		cmatind[2*c + 1] = m + j;
+		cmatval[2*c + 1] = 1.0;
+	}
+	int status = CPXaddcols(env, lp, count, 2 * count, obj.data(), cmatbeg.data(), cmatind.data(), cmatval.data(), lb.data(), ub.data(), NULL);
+	if (status) {
+		std::cerr << "error: GMKP CPXaddcols failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+
+	// constraint (4) of each new x: x_ij - y_ik <= 0
+	std::vector<int> rmatbeg(count);
+	std::vector<double> rhs(count, 0.0);
+	std::vector<char> sense(count, 'L');
+	std::vector<int> rmatind(2 * count);
+	std::vector<double> rmatval(2 * count);
+	for (int c = 0; c < count; c++) {
+		int i = indices[c] / n;
+		int j = indices[c] % n;
+		rmatbeg[c] = 2 * c;
+		rmatind[2*c] = i*r + cols.itemClass[j];
+		rmatval[2*c] = -1;
+		rmatind[2*c + 1] = first + c;
+		rmatval[2*c + 1] = 1;
+
+		cols.lpIndex[indices[c]] = first + c;
+		cols.fullIndex.push_back(indices[c]);
+	}
+	status = CPXaddrows(env, lp, 0, count, 2 * count, rhs.data(), sense.data(), rmatbeg.data(), rmatind.data(), rmatval.data(), NULL, NULL);
+	if (status) {
+		std::cerr << "error: GMKP CPXaddrows (4-th constraint) failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+	return 0;
+}
+
+int priceColumns(CPXENVptr env, CPXLPptr lp, ColumnSet &cols, int &added) {
+
+	int n = cols.n;
+	int m = cols.m;
+	int r = cols.r;
+	added = 0;
+
+	// duals of (1) and (2), upper bounds of the y (no x of a closed class)
+	cols.pi.resize(m + n);
+	cols.yUb.resize(m*r);
+	int status = CPXgetpi(env, lp, cols.pi.data(), 0, m + n - 1);
+	if (!status)
+		status = CPXgetub(env, lp, cols.yUb.data(), 0, m*r - 1);
+	if (status) {
+		std::cerr << "error: GMKP failed to obtain the duals of the restricted master" << std::endl;
+		return GMKP_ERROR_SOLUTION;
+	}
+
+	// the x of a column in the lp may have a positive value here (dual of its row (4)): looked up only then
+	cols.candidates.clear();
+	for (int i = 0; i < m; i++)
+		for (int k = 0; k < r; k++) {
+			if (cols.yUb[i*r + k] < 0.5)
+				continue;
+			for (int z = k > 0 ? cols.indexes[k - 1] : 0; z < cols.indexes[k]; z++) {
+				int j = cols.classes[z];
+				int c = i*n + j;
+				double reducedCost = cols.profits[c] - cols.weights[j] * cols.pi[i] - cols.pi[m + j];
+				if (reducedCost > 1e-6 && !cols.lpIndex.count(c) && !cols.fixedZero.count(c))
+					cols.candidates.push_back(std::make_pair(-reducedCost, c));
+			}
+		}
+
+	if (cols.candidates.empty())
+		return 0;
+
+	// the best reduced costs
+	if ((int)cols.candidates.size() > cols.batch) {
+		std::nth_element(cols.candidates.begin(), cols.candidates.begin() + (cols.batch - 1), cols.candidates.end());
+		cols.candidates.resize(cols.batch);
+	}
+	std::vector<int> indices(cols.candidates.size());
+	for (size_t c = 0; c < cols.candidates.size(); c++)
+		indices[c] = cols.candidates[c].second;
+	std::sort(indices.begin(), indices.end());
+
+	added = (int)indices.size();
+	cols.rounds++;
+	return addColumns(env, lp, cols, added, indices.data());
+}
+
+int generateColumns(CPXENVptr env, CPXLPptr lp, ColumnSet &cols) {
+	int added = 1;
+	while (added > 0) {
+		// infeasible or stopped by the time limit: the caller looks at the status
+		if (CPXgetstat(env, lp) != CPX_STAT_OPTIMAL)
+			return 0;
+
+		int status = priceColumns(env, lp, cols, added);
+		if (!status && added > 0)
+			status = CPXlpopt(env, lp) ? GMKP_ERROR_OPTIMIZE : 0;
+		if (status) {
+			if (status == GMKP_ERROR_OPTIMIZE)
+				std::cerr << "error: GMKP failed to optimize" << std::endl;
+			return status;
+		}
+	}
+	return 0;
+}
+
+int changeBounds(CPXENVptr env, CPXLPptr lp, ColumnSet *cols, int cnt, const int *indices, const char *lu, const double *bd) {
+
+	if (cols == NULL)
+		return CPXchgbds(env, lp, cnt, indices, lu, bd);
+
+	int n = cols->n;
+	int m = cols->m;
+
+	// the x not in the lp that get a positive lower bound are added first
+	std::vector<int> missing;
+	for (int c = 0; c < cnt; c++)
+		if (indices[c] < n*m && lu[c] != 'U' && bd[c] > 0 && !cols->lpIndex.count(indices[c]))
+			missing.push_back(indices[c]);
+	if (!missing.empty()) {
+		std::sort(missing.begin(), missing.end());
+		missing.erase(std::unique(missing.begin(), missing.end()), missing.end());
+		int status = addColumns(env, lp, *cols, (int)missing.size(), missing.data());
+		if (status)
+			return status;
+	}
+
+	std::vector<int> lpIndices;
+	std::vector<char> lpLu;
+	std::vector<double> lpBd;
+	for (int c = 0; c < cnt; c++) {
+		int f = indices[c];
+		int column = f >= n*m ? f - n*m : lpColumn(*cols, f);
+		if (column >= 0) {
+			lpIndices.push_back(column);
+		}
+		else {
+			// missing x: only the upper bound is kept (0 or 1)
+			if (lu[c] != 'L' && bd[c] < 0.5)
+				cols->fixedZero.insert(f);
+			if (lu[c] != 'L' && bd[c] >= 0.5)
+				cols->fixedZero.erase(f);
+			continue;
+		}
+		lpLu.push_back(lu[c]);
+		lpBd.push_back(bd[c]);
+	}
+
+	return lpIndices.empty() ? 0 : CPXchgbds(env, lp, (int)lpIndices.size(), lpIndices.data(), lpLu.data(), lpBd.data());
+}
+
+int getBounds(CPXENVptr env, CPXLPptr lp, ColumnSet *cols, double *lb, double *ub, int begin, int end) {
+
+	if (cols == NULL) {
+		int status = CPXgetlb(env, lp, lb, begin, end);
+		return status ? status : CPXgetub(env, lp, ub, begin, end);
+	}
+
+	int n = cols->n;
+	int m = cols->m;
+	int numcols = CPXgetnumcols(env, lp);
+	std::vector<double> lpLb(numcols);
+	std::vector<double> lpUb(numcols);
+	int status = CPXgetlb(env, lp, lpLb.data(), 0, numcols - 1);
+	if (!status)
+		status = CPXgetub(env, lp, lpUb.data(), 0, numcols - 1);
+	if (status)
+		return status;
+
+	for (int f = begin; f <= end; f++) {
+		int c = f >= n*m ? f - n*m : lpColumn(*cols, f);
+		lb[f - begin] = c >= 0 ? lpLb[c] : 0.0;
+		ub[f - begin] = c >= 0 ? lpUb[c] : (cols->fixedZero.count(f) ? 0.0 : 1.0);
+	}
+	return 0;
+}
+
+int getColumnValues(CPXENVptr env, CPXLPptr lp, ColumnSet &cols, double *x) {
+
+	int numcols = CPXgetnumcols(env, lp);
+	cols.lpValues.resize(numcols);
+	int status = CPXgetx(env, lp, cols.lpValues.data(), 0, numcols - 1);
+	if (status)
+		return status;
+
+	std::fill(x, x + (size_t)cols.n * cols.m, 0.0);
+	for (int c = 0; c < numcols; c++)
+		x[cols.fullIndex[c]] = cols.lpValues[c];
+	return 0;
+}
@@ -0,0 +1,70 @@
+#include <ilcplex/cplex.h>
+
+#include <iostream>
+#include <vector>
+#include <unordered_set>
+#include <unordered_map>
+#include <algorithm>
+
+#include "GMKP.h"
+#include "UTILITY.h"
+
+#ifndef COLUMNS_H_
+#define COLUMNS_H_
+
+/* restricted master: the lp holds all the y(i,k) but only the x(i,j) added so far
+ * columns of the lp: y(i,k) at i*r + k, then the x in the order they are added
+ * rows of the lp: (1) 0 ... m-1, (2) m ... m+n-1, (3) m+n ... m+n+r-1 as in the full model,
+ * then the row (4) x(i,j) - y(i,k) <= 0 of each x added
+ * outside this module the columns keep their index of the full model (i*n + j, n*m + i*r + k)
+ * the lp of CPLEX and the column set grow with the x added; x, the bounds and the trail of the dive stay dense over
+ * the n*m x, like the profits they are computed from
+ * */
+struct ColumnSet {
+	int n;
+	int m;
+	int r;
+	int *weights;
+	int *profits;
+	int *classes;
+	int *indexes;
+	std::vector<int> itemClass;
+	std::unordered_map<int, int> lpIndex; // column of the lp of each x(i,j) in the lp
+	std::vector<int> fullIndex; // index in the full model of each column of the lp
+	std::unordered_set<int> fixedZero; // x(i,j) not in the lp fixed to 0
+	int batch; // columns added by a pricing round at most
+	int rounds; // pricing rounds that added columns
+	// buffers
+	std::vector<double> lpValues;
+	std::vector<double> pi;
+	std::vector<double> yUb;
+	std::vector<std::pair<double, int>> candidates;
+};
+
+/* build the restricted master with the columnsPerClass x(i,j) of the best p(i,j)/w(j) of each class in each knapsack
+ * (0 or GMKP_ERROR_MODEL)
+ * */
+int buildRestrictedModel(CPXENVptr env, CPXLPptr lp, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, int columnsPerClass, int batch, ColumnSet &cols);
+
+// add the columns x (full indices not in the lp) with their rows (4)
+int addColumns(CPXENVptr env, CPXLPptr lp, ColumnSet &cols, int count, const int *indices);
+
+/* after an optimal LP: reduced cost p(i,j) - w(j) pi(i) - mu(j) of each x not in the lp (from the duals of (1) and (2),
+ * the row (4) of a missing column has dual 0), class by class over the classes open in each knapsack; at most batch
+ * columns with positive reduced cost are added
+ * */
+int priceColumns(CPXENVptr env, CPXLPptr lp, ColumnSet &cols, int &added);
+
+// optimize, price and optimize again until no column is added (the LP of the full model is optimal)
+int generateColumns(CPXENVptr env, CPXLPptr lp, ColumnSet &cols);
+
+// CPXchgbds with full indices (cols NULL: the full model); lower bound > 0 on a missing x: the column is added
+int changeBounds(CPXENVptr env, CPXLPptr lp, ColumnSet *cols, int cnt, const int *indices, const char *lu, const double *bd);
+
+// CPXgetlb / CPXgetub of the full indices [begin, end] (cols NULL: the full model)
+int getBounds(CPXENVptr env, CPXLPptr lp, ColumnSet *cols, double *lb, double *ub, int begin, int end);
+
+// x of the full model from the LP solution (the missing x are 0)
+int getColumnValues(CPXENVptr env, CPXLPptr lp, ColumnSet &cols, double *x);
+
+#endif /* COLUMNS_H_ */
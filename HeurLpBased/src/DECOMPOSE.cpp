@@ -0,0 +1,257 @@
+#include "DECOMPOSE.h"
+
+// sub-instance of the classes of a part (items and classes numbered again, in the order of classes/indexes)
+struct SubInstance {
+	int n;
+	int r;
+	std::vector<int> items; // item of the instance of each item
+	std::vector<int> classIds; // class of the instance of each class
+	std::vector<int> b;
+	std::vector<int> weights;
+	std::vector<int> profits;
+	std::vector<int> capacities;
+	std::vector<int> setups;
+	std::vector<int> classes;
+	std::vector<int> indexes;
+	Solution solution;
+	int status;
+	double time;
+};
+
+void initDecomposeParameters(DecomposeParameters &params) {
+	params.parts = 2;
+	params.threads = 0;
+	params.TL = 0;
+	params.exactSubproblems = true;
+	params.verbose = true;
+}
+
+void updateProfit(Solution &solution, int * profits) {
+	solution.objval = 0;
+	for (int j = 0; j < solution.n; j++)
+		if (solution.itemKnapsack[j] >= 0)
+			solution.objval += profits[solution.itemKnapsack[j] * solution.n + j];
+}
+
+int solveDecomposed(int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, DecomposeParameters &params, Solution &solution, DecomposeResult &result) {
+
+	int parts = std::max(1, std::min(params.parts, r));
+
+	// classes from the largest, each one to the part with the fewest items
+	std::vector<int> order(r);
+	for (int k = 0; k < r; k++)
+		order[k] = k;
+	auto size = [&](int k) { return indexes[k] - (k > 0 ? indexes[k - 1] : 0); };
+	std::sort(order.begin(), order.end(), [&](int a, int c) {
+		return size(a) != size(c) ? size(a) > size(c) : a < c;
+	});
+	std::vector<long long> partItems(parts, 0);
+	std::vector<std::vector<int>> partClasses(parts);
+	for (int t = 0; t < r; t++) {
+		int p = (int)(std::min_element(partItems.begin(), partItems.end()) - partItems.begin());
+		partClasses[p].push_back(order[t]);
+		partItems[p] += size(order[t]);
+	}
+
+	// load of each part: weights of its items and setups of its classes
+	std::vector<long long> load(parts, 0);
+	long long totalLoad = 0;
+	for (int p = 0; p < parts; p++) {
+		std::sort(partClasses[p].begin(), partClasses[p].end());
+		for (size_t c = 0; c < partClasses[p].size(); c++) {
+			int k = partClasses[p][c];
+			load[p] += setups[k];
+			for (int z = k > 0 ? indexes[k - 1] : 0; z < indexes[k]; z++)
+				load[p] += weights[classes[z]];
+		}
+		totalLoad += load[p];
+	}
+
+	std::vector<SubInstance> subs(parts);
+	for (int p = 0; p < parts; p++) {
+		SubInstance &sub = subs[p];
+		sub.r = (int)partClasses[p].size();
+		sub.classIds = partClasses[p];
+		for (int c = 0; c < sub.r; c++) {
+			int k = sub.classIds[c];
+			sub.b.push_back(b[k]);
+			sub.setups.push_back(setups[k]);
+			for (int z = k > 0 ? indexes[k - 1] : 0; z < indexes[k]; z++) {
+				sub.classes.push_back((int)sub.items.size());
+				sub.items.push_back(classes[z]);
+				sub.weights.push_back(weights[classes[z]]);
+			}
+			sub.indexes.push_back((int)sub.items.size());
+		}
+		sub.n = (int)sub.items.size();
+
+		// the shares of a capacity are rounded down, so their sum is not greater than the capacity
+		for (int i = 0; i < m; i++)
+			sub.capacities.push_back(totalLoad > 0 ? (int)((long double)capacities[i] * load[p] / totalLoad) : 0);
+		sub.profits.resize((size_t)m * sub.n);
+		for (int i = 0; i < m; i++)
+			for (int j = 0; j < sub.n; j++)
+				sub.profits[(size_t)i * sub.n + j] = profits[(size_t)i * n + sub.items[j]];
+		initSolution(sub.solution, sub.n, m, sub.r);
+		sub.status = 0;
+		sub.time = 0;
+	}
+
+	// the sub-instances, each one with its own CPLEX environment
+	int threads = params.threads > 0 ? params.threads : (int)std::thread::hardware_concurrency();
+	threads = std::max(1, std::min(threads, parts));
+	std::atomic<int> next(0);
+	double start = wallClock();
+	auto work = [&]() {
+		int p;
+		while ((p = next.fetch_add(1)) < parts) {
+			SubInstance &sub = subs[p];
+			SolveParameters solveParams;
+			initSolveParameters(solveParams);
+			solveParams.verbose = false;
+			solveParams.TL = params.TL;
+			solveParams.exactSubproblems = params.exactSubproblems;
+			double t = wallClock();
+			sub.status = solve(sub.n, m, sub.r, sub.b.data(), sub.weights.data(), sub.profits.data(), sub.capacities.data(), sub.setups.data(), sub.classes.data(), sub.indexes.data(), solveParams, sub.solution);
+			sub.time = wallClock() - t;
+		}
+	};
+	std::vector<std::thread> workers;
+	for (int t = 0; t < threads; t++)
+		workers.push_back(std::thread(work));
+	for (size_t t = 0; t < workers.size(); t++)
+		workers[t].join();
+	result.solveTime = wallClock() - start;
+
+	// merge the feasible solutions of the sub-instances
+	int status = 0;
+	for (int j = 0; j < n; j++)
+		solution.itemKnapsack[j] = -1;
+	memset(solution.openClasses, 0, sizeof(char) * m * r);
+	for (int p = 0; p < parts; p++) {
+		SubInstance &sub = subs[p];
+		if (params.verbose)
+			std::cout << "Part " << p << ": " << sub.r << " classes, " << sub.n << " items, objective " << sub.solution.objval << (sub.solution.status == 0 ? " (feasible)" : " (not feasible)") << ", time " << sub.time << std::endl;
+		if (sub.status && status == 0)
+			status = sub.status;
+		if (sub.status == 0 && sub.solution.status == 0) {
+			for (int j = 0; j < sub.n; j++)
+				solution.itemKnapsack[sub.items[j]] = sub.solution.itemKnapsack[j];
+			for (int i = 0; i < m; i++)
+				for (int c = 0; c < sub.r; c++)
+					solution.openClasses[i*r + sub.classIds[c]] = sub.solution.openClasses[i*sub.r + c];
+		}
+		freeSolution(sub.solution);
+	}
+	updateProfit(solution, profits);
+	result.parts = parts;
+	result.mergedObjval = solution.objval;
+
+	// capacity left by the shares
+	start = wallClock();
+	improveSolution(n, m, r, b, weights, profits, capacities, setups, classes, indexes, solution, result.addedItems, result.openedClasses);
+	result.improveTime = wallClock() - start;
+
+	double *x = new double[(size_t)n * m + m * r];
+	solutionToX(solution, x);
+	solution.status = checkSolution(x, solution.objval, n, m, r, b, weights, profits, capacities, setups, classes, indexes);
+	solution.time = result.solveTime + result.improveTime;
+	delete[] x;
+
+	return status;
+}
+
+void improveSolution(int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, Solution &solution, int &addedItems, int &openedClasses) {
+
+	addedItems = 0;
+	openedClasses = 0;
+
+	int *itemClass = (int *)malloc(sizeof(int) * n);
+	computeItemClass(n, r, classes, indexes, itemClass);
+
+	std::vector<long long> residual(m);
+	for (int i = 0; i < m; i++) {
+		residual[i] = capacities[i];
+		for (int k = 0; k < r; k++)
+			if (solution.openClasses[i*r + k])
+				residual[i] -= setups[k];
+	}
+	for (int j = 0; j < n; j++)
+		if (solution.itemKnapsack[j] >= 0)
+			residual[solution.itemKnapsack[j]] -= weights[j];
+
+	std::vector<int> openCount(r, 0);
+	for (int i = 0; i < m; i++)
+		for (int k = 0; k < r; k++)
+			openCount[k] += solution.openClasses[i*r + k];
+
+	// free items of the classes already open: one knapsack after the other on the residual capacity
+	for (int i = 0; i < m; i++) {
+		if (residual[i] <= 0)
+			continue;
+		ResidualKnapsack problem;
+		problem.capacity = residual[i];
+		for (int j = 0; j < n; j++)
+			if (solution.itemKnapsack[j] < 0 && solution.openClasses[i*r + itemClass[j]] && weights[j] <= residual[i]) {
+				problem.items.push_back(j);
+				problem.profits.push_back(profits[(size_t)i * n + j]);
+				problem.weights.push_back(weights[j]);
+			}
+		if (problem.items.empty())
+			continue;
+		solveKnapsack(problem);
+		for (size_t t = 0; t < problem.items.size(); t++)
+			if (problem.chosen[t]) {
+				solution.itemKnapsack[problem.items[t]] = i;
+				residual[i] -= problem.weights[t];
+				addedItems++;
+			}
+	}
+
+	// classes still allowed by b(k): each one opened in the knapsack where its free items give the largest profit
+	for (int k = 0; k < r; k++) {
+		int first = k > 0 ? indexes[k - 1] : 0;
+		while (openCount[k] < b[k]) {
+			ResidualKnapsack best;
+			best.value = 0;
+			int bestKnapsack = -1;
+			for (int i = 0; i < m; i++) {
+				if (solution.openClasses[i*r + k] || residual[i] - setups[k] <= 0)
+					continue;
+				ResidualKnapsack problem;
+				problem.capacity = residual[i] - setups[k];
+				for (int z = first; z < indexes[k]; z++) {
+					int j = classes[z];
+					if (solution.itemKnapsack[j] < 0 && weights[j] <= problem.capacity) {
+						problem.items.push_back(j);
+						problem.profits.push_back(profits[(size_t)i * n + j]);
+						problem.weights.push_back(weights[j]);
+					}
+				}
+				if (problem.items.empty())
+					continue;
+				solveKnapsack(problem);
+				if (problem.value > best.value) {
+					best = problem;
+					bestKnapsack = i;
+				}
+			}
+			if (bestKnapsack < 0)
+				break;
+
+			solution.openClasses[bestKnapsack*r + k] = 1;
+			residual[bestKnapsack] -= setups[k];
+			openCount[k]++;
+			openedClasses++;
+			for (size_t t = 0; t < best.items.size(); t++)
+				if (best.chosen[t]) {
+					solution.itemKnapsack[best.items[t]] = bestKnapsack;
+					residual[bestKnapsack] -= best.weights[t];
+					addedItems++;
+				}
+		}
+	}
+
+	free(itemClass);
+	updateProfit(solution, profits);
+}
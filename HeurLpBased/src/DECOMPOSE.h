@@ -0,0 +1,46 @@
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+#include "LPBASED_CPX.h"
+
+#ifndef DECOMPOSE_H_
+#define DECOMPOSE_H_
+
+/* decomposition of a large instance: the classes are split in parts with about the same number of items,
+ * each part is a sub-instance with all the knapsacks, a share of each capacity proportional to the weights
+ * and setups of its classes, and the b(k) of its classes (each class is in one part only);
+ * the sub-instances are solved by the dive at the same time, their solutions are merged and the capacity
+ * left unused by the shares is filled by the improvement pass
+ * */
+struct DecomposeParameters {
+	int parts; // sub-instances
+	int threads; // sub-instances solved at the same time (0: one for each core)
+	int TL; // time limit of each LP of the dives (0: none)
+	bool exactSubproblems;
+	bool verbose; // one line for each sub-instance
+};
+
+struct DecomposeResult {
+	int parts; // sub-instances solved (not more than the classes)
+	double mergedObjval; // objective of the merged solutions of the sub-instances
+	int addedItems; // items added by the improvement pass
+	int openedClasses; // classes opened by the improvement pass
+	double solveTime; // wall time of the dives
+	double improveTime;
+};
+
+void initDecomposeParameters(DecomposeParameters &params);
+
+// the solution is feasible for the whole instance; returns 0 or the first GMKP_ERROR code of the sub-instances
+int solveDecomposed(int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, DecomposeParameters &params, Solution &solution, DecomposeResult &result);
+
+/* add unassigned items to a feasible solution: first the knapsack of the free items of the classes open in each knapsack
+ * (exact subsolver on the residual capacity), then the classes still allowed by b(k) are opened where their knapsack
+ * gives the largest profit; solution.objval is updated
+ * */
+void improveSolution(int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, Solution &solution, int &addedItems, int &openedClasses);
+
+#endif /* DECOMPOSE_H_ */
@@ -0,0 +1,258 @@
+#include "GENERATOR.h"
+#include "INSTANCE.h"
+
+// streams of random numbers (one for each kind of data)
+#define STREAM_WEIGHTS 1
+#define STREAM_CAPACITIES 2
+#define STREAM_PROFITS 3
+#define STREAM_CLASSES 4
+#define STREAM_SETUPS 5
+#define STREAM_B 6
+
+int randomInt(unsigned long long seed, int stream, unsigned long long index, int lo, int hi);
+double randomDouble(unsigned long long seed, int stream, unsigned long long index);
+int itemWeight(GeneratorParameters &params, int item);
+int itemProfit(GeneratorParameters &params, int knapsack, int item);
+int classSetup(GeneratorParameters &params, int class1);
+int classB(GeneratorParameters &params, int class1);
+void computeCardinalities(GeneratorParameters &params, int *cardinalities);
+void computeCapacities(GeneratorParameters &params, int *capacities);
+
+void initGeneratorParameters(GeneratorParameters &params) {
+	params.n = 25;
+	params.m = 2;
+	params.r = 5;
+	params.seed = 1;
+	params.classDistribution = CLASSES_RANDOM;
+	params.profitCorrelation = PROFITS_UNCORRELATED;
+	params.tightness = 0.5;
+	params.bMin = 1;
+	params.bMax = 2;
+	params.wMin = 10;
+	params.wMax = 100;
+	params.pMin = 10;
+	params.pMax = 100;
+}
+
+int generateInstance(char *file_name, GeneratorParameters &params) {
+
+	if (params.n < 1 || params.m < 1 || params.r < 1 || params.r > params.n)
+		return 2;
+	if (params.bMin < 1 || params.bMax < params.bMin || params.wMin < 1 || params.wMax < params.wMin || params.pMin < 0 || params.pMax < params.pMin || params.tightness <= 0)
+		return 2;
+
+	std::string path = std::string("./instances/") + file_name;
+
+	size_t length = strlen(file_name);
+	bool binary = length > 4 && strcmp(file_name + length - 4, ".bin") == 0;
+
+	FILE *file = fopen(path.c_str(), binary ? "wb" : "w");
+	if (file == NULL)
+		return 1;
+
+	int n = params.n;
+	int m = params.m;
+	int r = params.r;
+
+	// only O(m + r) data are kept in memory, items are computed on the fly
+	int *capacities = (int *)malloc(sizeof(int) * m);
+	int *cardinalities = (int *)malloc(sizeof(int) * r);
+	computeCapacities(params, capacities);
+	computeCardinalities(params, cardinalities);
+
+	BufferedWriter out(file);
+
+	if (binary) {
+		out.writeRaw(BINARY_INSTANCE_MAGIC, 8);
+		out.writeRaw(&n, sizeof(int));
+		out.writeRaw(&m, sizeof(int));
+		out.writeRaw(&r, sizeof(int));
+
+		for (int j = 0; j < n; j++) {
+			int value = itemWeight(params, j);
+			out.writeRaw(&value, sizeof(int));
+		}
+
+		out.writeRaw(capacities, sizeof(int) * m);
+
+		for (int i = 0; i < m; i++)
+			for (int j = 0; j < n; j++) {
+				int value = itemProfit(params, i, j);
+				out.writeRaw(&value, sizeof(int));
+			}
+	}
+	else {
+		out.write("sets\n");
+		out.write("j items\t"); out.write(n); out.write('\n');
+		out.write("k knapsacks\t"); out.write(m); out.write('\n');
+		out.write("r classes\t"); out.write(r); out.write('\n');
+
+		out.write("parameter w(j)\n");
+		for (int j = 0; j < n; j++) {
+			out.write(j + 1); out.write('\t'); out.write(itemWeight(params, j)); out.write('\n');
+		}
+		out.write('\n');
+
+		out.write("parameter cap(i)\n");
+		for (int i = 0; i < m; i++) {
+			out.write(i + 1); out.write('\t'); out.write(capacities[i]); out.write('\n');
+		}
+		out.write('\n');
+
+		out.write("parameter p(i, j)\n");
+		for (int i = 0; i < m; i++)
+			for (int j = 0; j < n; j++) {
+				out.write(j + 1); out.write('\t'); out.write(i + 1); out.write('\t'); out.write(itemProfit(params, i, j)); out.write('\n');
+			}
+		out.write('\n');
+
+		out.write("parameter t(r,j)\n");
+	}
+
+	// class of each item
+	int class1 = 0;
+	int remaining = cardinalities[0];
+	for (int j = 0; j < n; j++) {
+
+		int value;
+		if (params.classDistribution == CLASSES_RANDOM) {
+			// the first r items guarantee that no class is empty
+			value = j < r ? j : randomInt(params.seed, STREAM_CLASSES, j, 0, r - 1);
+		}
+		else {
+			// the classes are consecutive blocks of items
+			while (remaining == 0)
+				remaining = cardinalities[++class1];
+			remaining--;
+			value = class1;
+		}
+
+		if (binary) {
+			out.writeRaw(&value, sizeof(int));
+		}
+		else {
+			out.write(j + 1); out.write('\t'); out.write(value + 1); out.write('\n');
+		}
+	}
+
+	if (binary) {
+		for (int k = 0; k < r; k++) {
+			int value = classSetup(params, k);
+			out.writeRaw(&value, sizeof(int));
+		}
+		for (int k = 0; k < r; k++) {
+			int value = classB(params, k);
+			out.writeRaw(&value, sizeof(int));
+		}
+	}
+	else {
+		out.write('\n');
+
+		out.write("parameter s(r)\n");
+		for (int k = 0; k < r; k++) {
+			out.write(k + 1); out.write('\t'); out.write(classSetup(params, k)); out.write('\n');
+		}
+		out.write('\n');
+
+		out.write("parameter b(k)\n");
+		for (int k = 0; k < r; k++) {
+			out.write(k + 1); out.write('\t'); out.write(classB(params, k)); out.write('\n');
+		}
+	}
+
+	out.flush();
+	int status = ferror(file) ? 3 : 0;
+	fclose(file);
+
+	free(capacities);
+	free(cardinalities);
+
+	return status;
+}
+
+// the value depends only on (seed, stream, index), so every value can be computed again without storing it
+int randomInt(unsigned long long seed, int stream, unsigned long long index, int lo, int hi) {
+	unsigned long long h = mix64(seed ^ mix64(((unsigned long long)stream << 56) ^ index));
+	return lo + (int)(h % (unsigned long long)(hi - lo + 1));
+}
+
+double randomDouble(unsigned long long seed, int stream, unsigned long long index) {
+	unsigned long long h = mix64(seed ^ mix64(((unsigned long long)stream << 56) ^ index));
+	return (h >> 11) * (1.0 / 9007199254740992.0);
+}
+
+int itemWeight(GeneratorParameters &params, int item) {
+	return randomInt(params.seed, STREAM_WEIGHTS, item, params.wMin, params.wMax);
+}
+
+int itemProfit(GeneratorParameters &params, int knapsack, int item) {
+
+	unsigned long long index = (unsigned long long)knapsack * params.n + item;
+	int delta = params.wMax / 10;
+	int profit;
+
+	if (params.profitCorrelation == PROFITS_WEAKLY_CORRELATED)
+		profit = itemWeight(params, item) + randomInt(params.seed, STREAM_PROFITS, index, -delta, delta);
+	else if (params.profitCorrelation == PROFITS_STRONGLY_CORRELATED)
+		profit = itemWeight(params, item) + delta;
+	else
+		profit = randomInt(params.seed, STREAM_PROFITS, index, params.pMin, params.pMax);
+
+	return profit > 1 ? profit : 1;
+}
+
+int classSetup(GeneratorParameters &params, int class1) {
+	return randomInt(params.seed, STREAM_SETUPS, class1, params.wMin, params.wMax);
+}
+
+int classB(GeneratorParameters &params, int class1) {
+	int bMax = params.bMax < params.m ? params.bMax : params.m;
+	int bMin = params.bMin < bMax ? params.bMin : bMax;
+	return randomInt(params.seed, STREAM_B, class1, bMin, bMax);
+}
+
+void computeCardinalities(GeneratorParameters &params, int *cardinalities) {
+
+	int n = params.n;
+	int r = params.r;
+
+	// each class has at least one item
+	for (int k = 0; k < r; k++)
+		cardinalities[k] = 1;
+
+	if (params.classDistribution == CLASSES_SKEWED) {
+		double harmonic = 0;
+		for (int k = 0; k < r; k++)
+			harmonic += 1.0 / (k + 1);
+
+		int assigned = r;
+		for (int k = 0; k < r; k++) {
+			int extra = (int)((n - r) / harmonic / (k + 1));
+			cardinalities[k] += extra;
+			assigned += extra;
+		}
+		cardinalities[0] += n - assigned;
+	}
+	else {
+		for (int k = 0; k < r; k++)
+			cardinalities[k] += (n - r) / r + (k < (n - r) % r ? 1 : 0);
+	}
+}
+
+void computeCapacities(GeneratorParameters &params, int *capacities) {
+
+	// sum of weights and setups (the weights are computed again, they are not stored)
+	double total = 0;
+	for (int j = 0; j < params.n; j++)
+		total += itemWeight(params, j);
+	for (int k = 0; k < params.r; k++)
+		total += classSetup(params, k);
+
+	// each knapsack can contain at least the biggest item with its setup
+	int minCapacity = 2 * params.wMax;
+
+	for (int i = 0; i < params.m; i++) {
+		double capacity = params.tightness * total / params.m * (0.9 + 0.2 * randomDouble(params.seed, STREAM_CAPACITIES, i));
+		capacities[i] = capacity > minCapacity ? (int)capacity : minCapacity;
+	}
+}
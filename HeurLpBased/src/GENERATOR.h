@@ -0,0 +1,44 @@
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <string>
+
+#include "OUTPUT.h"
+
+#ifndef GENERATOR_H_
+#define GENERATOR_H_
+
+// distribution of the items among the classes
+#define CLASSES_UNIFORM 0 // all the classes have (almost) the same cardinality
+#define CLASSES_RANDOM 1 // each item picks its class at random
+#define CLASSES_SKEWED 2 // cardinality of the k-th class proportional to 1/k
+
+// correlation between the profits and the weights
+#define PROFITS_UNCORRELATED 0 // p(i,j) random in [pMin, pMax]
+#define PROFITS_WEAKLY_CORRELATED 1 // p(i,j) = w(j) + random noise in [-wMax/10, wMax/10]
+#define PROFITS_STRONGLY_CORRELATED 2 // p(i,j) = w(j) + wMax/10 (same profits in all the knapsacks)
+
+struct GeneratorParameters {
+	int n; // number of objects
+	int m; // number of knapsacks
+	int r; // number of subsets
+	unsigned long long seed;
+	int classDistribution;
+	int profitCorrelation;
+	double tightness; // sum of the capacities / (sum of the weights + sum of the setups)
+	int bMin; // range of b(k)
+	int bMax;
+	int wMin; // range of weights and setups
+	int wMax;
+	int pMin; // range of uncorrelated profits
+	int pMax;
+};
+
+// set the default values (same ranges of randomGMKP_1.inc)
+void initGeneratorParameters(GeneratorParameters &params);
+
+// write a random instance: .bin extension for the binary format, .inc format otherwise
+// the values are computed when they are written, so the memory used does not depend on n
+int generateInstance(char *file_name, GeneratorParameters &params);
+
+#endif /* GENERATOR_H_ */
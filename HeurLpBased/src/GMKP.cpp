@@ -0,0 +1,194 @@
+#include "GMKP.h"
+#include "INSTANCE.h"
+#include "LPBASED_CPX.h"
+#include "BRANCHBOUND.h"
+
+int *copyInstanceArray(const int *values, size_t size) {
+	int *copy = (int *)malloc(sizeof(int) * size);
+	if (copy != NULL)
+		memcpy(copy, values, sizeof(int) * size);
+	return copy;
+}
+
+void clearInstance(GmkpInstance &instance) {
+	instance.n = 0;
+	instance.m = 0;
+	instance.r = 0;
+	instance.weights = NULL;
+	instance.capacities = NULL;
+	instance.profits = NULL;
+	instance.classes = NULL;
+	instance.indexes = NULL;
+	instance.setups = NULL;
+	instance.b = NULL;
+}
+
+int gmkpReadInstance(const char *path, GmkpInstance &instance) {
+
+	clearInstance(instance);
+
+	std::ifstream file(path, std::ios::binary);
+	if (!file.is_open())
+		return GMKP_ERROR_INSTANCE;
+	std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+	return gmkpReadInstanceData(data.data(), data.size(), instance);
+}
+
+int gmkpReadInstanceData(const char *data, size_t size, GmkpInstance &instance) {
+
+	clearInstance(instance);
+
+	int status = readInstanceData(data, size, instance.n, instance.m, instance.r, instance.weights, instance.capacities, instance.profits, instance.classes, instance.indexes, instance.setups, instance.b);
+	if (status) {
+		gmkpFreeInstance(instance);
+		return GMKP_ERROR_INSTANCE;
+	}
+	return GMKP_OK;
+}
+
+int gmkpCreateInstance(GmkpInstance &instance, int n, int m, int r, const int *weights, const int *capacities, const int *profits, const int *itemClass, const int *setups, const int *b) {
+
+	clearInstance(instance);
+	if (n < 1 || m < 1 || r < 1 || !validInstanceSizes(n, m, r))
+		return GMKP_ERROR_INSTANCE;
+
+	instance.n = n;
+	instance.m = m;
+	instance.r = r;
+	instance.weights = copyInstanceArray(weights, n);
+	instance.capacities = copyInstanceArray(capacities, m);
+	instance.profits = copyInstanceArray(profits, (size_t)n * m);
+	instance.setups = copyInstanceArray(setups, r);
+	instance.b = copyInstanceArray(b, r);
+	instance.classes = (int *)malloc(sizeof(int) * n);
+	instance.indexes = (int *)malloc(sizeof(int) * r);
+
+	bool allocated = instance.weights != NULL && instance.capacities != NULL && instance.profits != NULL && instance.setups != NULL && instance.b != NULL && instance.classes != NULL && instance.indexes != NULL;
+	if (!allocated || groupItemsByClass(n, r, itemClass, instance.classes, instance.indexes)) {
+		gmkpFreeInstance(instance);
+		return GMKP_ERROR_INSTANCE;
+	}
+	return GMKP_OK;
+}
+
+void gmkpFreeInstance(GmkpInstance &instance) {
+	free(instance.weights);
+	free(instance.capacities);
+	free(instance.profits);
+	free(instance.classes);
+	free(instance.indexes);
+	free(instance.setups);
+	free(instance.b);
+	clearInstance(instance);
+}
+
+void gmkpInitOptions(GmkpOptions &options) {
+	options.timeLimit = 0;
+	options.threads = 1;
+	options.strategy = GMKP_STRATEGY_DIVE;
+	options.exactSubproblems = true;
+	options.integralityTolerance = SOLUTION_EPS;
+	options.deterministic = false;
+	options.verbose = false;
+}
+
+int gmkpSolve(const GmkpInstance &instance, const GmkpOptions &options, GmkpResult &result) {
+
+	double start = wallClock();
+	int n = instance.n;
+	int m = instance.m;
+	int r = instance.r;
+
+	result.error = GMKP_OK;
+	result.objval = 0;
+	result.feasible = false;
+	result.optimal = false;
+	result.bound = 0;
+	result.gap = 0;
+	result.nodes = 0;
+	result.time = 0;
+	result.n = n;
+	result.m = m;
+	result.r = r;
+	result.itemKnapsack = NULL;
+	result.openClasses = NULL;
+
+	if (n < 1 || m < 1 || r < 1)
+		return result.error = GMKP_ERROR_INSTANCE;
+	if (options.timeLimit < 0 || options.threads < 1 || options.integralityTolerance < 0 || options.integralityTolerance >= 0.5 || (options.strategy != GMKP_STRATEGY_DIVE && options.strategy != GMKP_STRATEGY_BRANCH_AND_BOUND))
+		return result.error = GMKP_ERROR_OPTIONS;
+
+	Solution solution;
+	initSolution(solution, n, m, r);
+
+	SolveParameters params;
+	initSolveParameters(params);
+	params.timeLimit = options.timeLimit;
+	params.TL = (int)ceil(options.timeLimit);
+	params.exactSubproblems = options.exactSubproblems;
+	params.integralityTolerance = options.integralityTolerance;
+	params.verbose = options.verbose;
+
+	result.error = solve(n, m, r, instance.b, instance.weights, instance.profits, instance.capacities, instance.setups, instance.classes, instance.indexes, params, solution);
+
+	if (!result.error && options.strategy == GMKP_STRATEGY_BRANCH_AND_BOUND) {
+		BranchAndBoundParameters bnbParams;
+		initBranchAndBoundParameters(bnbParams);
+		bnbParams.threads = options.threads;
+		bnbParams.deterministic = options.deterministic;
+		bnbParams.verbose = options.verbose;
+		bnbParams.timeLimit = options.timeLimit > 0 ? options.timeLimit - (wallClock() - start) : 1e30;
+		if (bnbParams.timeLimit < 0)
+			bnbParams.timeLimit = 0;
+
+		BranchAndBoundResult bnbResult;
+		result.error = branchAndBound(n, m, r, instance.b, instance.weights, instance.profits, instance.capacities, instance.setups, instance.classes, instance.indexes, bnbParams, solution, bnbResult, NULL);
+		result.optimal = !result.error && bnbResult.optimal;
+		result.bound = bnbResult.bound;
+		result.gap = bnbResult.gap;
+		result.nodes = bnbResult.nodes;
+	}
+
+	// the assignment is given also after an error of the branch and bound (incumbent)
+	result.objval = solution.objval;
+	result.feasible = solution.status == 0;
+	result.itemKnapsack = solution.itemKnapsack;
+	result.openClasses = solution.openClasses;
+	result.time = wallClock() - start;
+
+	return result.error;
+}
+
+void gmkpFreeResult(GmkpResult &result) {
+	free(result.itemKnapsack);
+	free(result.openClasses);
+	result.itemKnapsack = NULL;
+	result.openClasses = NULL;
+}
+
+const char *gmkpErrorString(int error) {
+	switch (error) {
+	case GMKP_OK:
+		return "no error";
+	case GMKP_ERROR_ENVIRONMENT:
+		return "CPLEX environment or lp not created";
+	case GMKP_ERROR_MODEL:
+		return "model not built";
+	case GMKP_ERROR_PARAMETERS:
+		return "CPLEX parameter not set";
+	case GMKP_ERROR_BOUNDS:
+		return "bounds not changed";
+	case GMKP_ERROR_OPTIMIZE:
+		return "LP not optimized";
+	case GMKP_ERROR_SOLUTION:
+		return "LP solution not available";
+	case GMKP_ERROR_INSTANCE:
+		return "instance not read or not valid";
+	case GMKP_ERROR_OPTIONS:
+		return "invalid options";
+	case GMKP_ERROR_INFEASIBLE:
+		return "LP infeasible";
+	}
+	return "unknown error";
+}
@@ -4,14 +4,82 @@
 
 #include "INSTANCE.h"
 #include "LPBASED_CPX.h"
+#include "GENERATOR.h"
+#include "REPORT.h"
+#include "WARMSTART.h"
+#include "BRANCHBOUND.h"
+#include "SERVER.h"
+#include "BATCH.h"
+#include "DECOMPOSE.h"
+#include "BENCH.h"
+#include "STRATEGY.h"
+#include "MEMORY.h"
 
 using namespace std;
 
+int generate(int argc, char **argv);
+int serve(int argc, char **argv);
+int client(int argc, char **argv);
+int scaling(int argc, char **argv);
+int batch(int argc, char **argv);
+int bench(int argc, char **argv);
+int replay(int argc, char **argv);
+int strategies(int argc, char **argv);
+
 int main(int argc, char **argv)
 {
+	if (argc >= 2 && strcmp(argv[1], "-generate") == 0)
+		return generate(argc, argv);
+	if (argc >= 2 && strcmp(argv[1], "-server") == 0)
+		return serve(argc, argv);
+	if (argc >= 2 && strcmp(argv[1], "-client") == 0)
+		return client(argc, argv);
+	if (argc >= 2 && strcmp(argv[1], "-scaling") == 0)
+		return scaling(argc, argv);
+	if (argc >= 2 && strcmp(argv[1], "-batch") == 0)
+		return batch(argc, argv);
+	if (argc >= 2 && strcmp(argv[1], "-bench") == 0)
+		return bench(argc, argv);
+	if (argc >= 2 && strcmp(argv[1], "-replay") == 0)
+		return replay(argc, argv);
+	if (argc >= 2 && strcmp(argv[1], "-strategies") == 0)
+		return strategies(argc, argv);
+
 	if (argc < 3) {
 		std::cout << "invalid parameters!\n";
-		std::cout << "parameters: [nameInstance] [timeout]\n";
+		std::cout << "parameters: [nameInstance] [timeout] [options]\n";
+		std::cout << "options: -trace [file.jsonl] (one JSON record for each LP of the dive)\n";
+		std::cout << "         -journal [file] (base model once in file.sav, then the bounds changed and the result of each LP of the dive)\n";
+		std::cout << "         -verbosity 0|1|2 (instance: nothing, summary, full dump)\n";
+		std::cout << "         -solution [file] (final assignment, .csv or binary)\n";
+		std::cout << "         -pool [k] [file] (k best feasible solutions of the dive, .csv or binary)\n";
+		std::cout << "         -warmstart [file] (solution of a previous run, repaired and fixed at the start)\n";
+		std::cout << "         -subsolver 0|1 (exact knapsack subsolver when all y are fixed, default 1)\n";
+		std::cout << "         -eps [tolerance] (LP values this close to 0 or 1 are integral in the dive, default 1e-6)\n";
+		std::cout << "         -buildthreads [k] (threads of the model build and of the checker, pinned to the NUMA nodes, default 0: all cores)\n";
+		std::cout << "         -colgen [k] (restricted master with the k best x of each class in each knapsack, the others added by pricing, default 0: full model)\n";
+		std::cout << "         -colbatch [k] (x added by a pricing round at most, default 0: n)\n";
+		std::cout << "         -symmetry 0|1 (orbit ordering of the identical knapsacks, default 1)\n";
+		std::cout << "         -decompose [parts] (classes split in sub-instances solved in parallel, merged and improved)\n";
+		std::cout << "         -decomposethreads [k] (sub-instances solved at the same time, default 0: one for each core)\n";
+		std::cout << "         -compare 0|1 (with -decompose, also the dive on the whole instance and the gap between them)\n";
+		std::cout << "         -compress 0|1 (profits stored in 1, 2 or 4 bytes for each knapsack and decoded by the model build, default 0)\n";
+		std::cout << "         -perf 0|1 (hardware counters of the model build, x scan, checker and LP phases, default 0)\n";
+		std::cout << "         -memlimit [MB] (peak memory estimated before the model build: compressed profits or decomposition if the full model is above it, otherwise the run stops)\n";
+		std::cout << "         -strategy auto|full|nosubsolver|colgen|decompose (subsolver, column generation, decomposition and threads set for the instance, auto: chosen from its features)\n";
+		std::cout << "         -bnb [seconds] (branch and bound after the dive, reports incumbent, bound and gap)\n";
+		std::cout << "         -bnbmem [MB] (memory of the open nodes of the branch and bound, default 1024)\n";
+		std::cout << "         -threads [k] (threads of the branch and bound, default 1)\n";
+		std::cout << "         -deterministic [nodes] (branch and bound in epochs of the given nodes, same result for any threads)\n";
+		std::cout << "         -bnbnodes [k] (nodes of the branch and bound at most)\n";
+		std::cout << "            -generate [nameInstance] [n] [m] [r] [seed] [options]\n";
+		std::cout << "            -server [socket] [options]\n";
+		std::cout << "            -client [socket] [instanceFile] [timeout] | -client [socket] -shutdown\n";
+		std::cout << "            -scaling [nameInstance] (model build and checker times from 1 thread to all cores)\n";
+		std::cout << "            -batch [directory] [timeout] [options] (all the instances of a directory, parse, build and solve pipelined)\n";
+		std::cout << "            -bench [timeout] [options] (seeded corpus compared with a baseline: objective, LPs, time)\n";
+		std::cout << "            -replay [journal] [lp] [model] (lp of the dive rebuilt from a journal, 0: the last one, written and solved again)\n";
+		std::cout << "            -strategies [directory] [timeout] (every strategy and the automatic choice on all the instances of a directory)\n";
 		return -1;
 	}
     srand(50321);
@@ -19,11 +87,123 @@ int main(int argc, char **argv)
 	// input parameters
 	char *instanceName = argv[1];
 	int TL = atoi(argv[2]);
+	char *traceFilename = NULL;
+	char *journalFilename = NULL;
+	int verbosity = PRINT_SUMMARY;
+	char *solutionFilename = NULL;
+	char *poolFilename = NULL;
+	int poolSize = 0;
+	char *warmStartFilename = NULL;
+	bool exactSubproblems = true;
+	double integralityTolerance = SOLUTION_EPS;
+	int buildThreads = 0;
+	int columnGeneration = 0;
+	int columnBatch = 0;
+	bool symmetry = true;
+	bool perf = false;
+	bool compress = false;
+	DecomposeParameters decomposeParams;
+	initDecomposeParameters(decomposeParams);
+	bool decompose = false;
+	bool compare = false;
+	bool strategy = false;
+	int strategyKind = STRATEGY_AUTO;
+	long long memoryLimit = 0;
+	BranchAndBoundParameters bnbParams;
+	initBranchAndBoundParameters(bnbParams);
+	bool bnb = false;
+
+	for (int i = 3; i < argc; i++) {
+		if (strcmp(argv[i], "-trace") == 0 && i + 1 < argc) {
+			traceFilename = argv[++i];
+		}
+		else if (strcmp(argv[i], "-journal") == 0 && i + 1 < argc) {
+			journalFilename = argv[++i];
+		}
+		else if (strcmp(argv[i], "-verbosity") == 0 && i + 1 < argc) {
+			verbosity = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-solution") == 0 && i + 1 < argc) {
+			solutionFilename = argv[++i];
+		}
+		else if (strcmp(argv[i], "-pool") == 0 && i + 2 < argc) {
+			poolSize = atoi(argv[++i]);
+			poolFilename = argv[++i];
+		}
+		else if (strcmp(argv[i], "-warmstart") == 0 && i + 1 < argc) {
+			warmStartFilename = argv[++i];
+		}
+		else if (strcmp(argv[i], "-subsolver") == 0 && i + 1 < argc) {
+			exactSubproblems = atoi(argv[++i]) != 0;
+		}
+		else if (strcmp(argv[i], "-eps") == 0 && i + 1 < argc) {
+			integralityTolerance = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-buildthreads") == 0 && i + 1 < argc) {
+			buildThreads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-colgen") == 0 && i + 1 < argc) {
+			columnGeneration = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-colbatch") == 0 && i + 1 < argc) {
+			columnBatch = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-symmetry") == 0 && i + 1 < argc) {
+			symmetry = atoi(argv[++i]) != 0;
+		}
+		else if (strcmp(argv[i], "-compress") == 0 && i + 1 < argc) {
+			compress = atoi(argv[++i]) != 0;
+		}
+		else if (strcmp(argv[i], "-perf") == 0 && i + 1 < argc) {
+			perf = atoi(argv[++i]) != 0;
+		}
+		else if (strcmp(argv[i], "-decompose") == 0 && i + 1 < argc) {
+			decompose = true;
+			decomposeParams.parts = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-decomposethreads") == 0 && i + 1 < argc) {
+			decomposeParams.threads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-compare") == 0 && i + 1 < argc) {
+			compare = atoi(argv[++i]) != 0;
+		}
+		else if (strcmp(argv[i], "-memlimit") == 0 && i + 1 < argc) {
+			memoryLimit = atoll(argv[++i]) << 20;
+		}
+		else if (strcmp(argv[i], "-strategy") == 0 && i + 1 < argc) {
+			strategy = true;
+			if (!parseStrategy(argv[++i], strategyKind)) {
+				std::cout << "unknown strategy: " << argv[i] << std::endl;
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "-bnb") == 0 && i + 1 < argc) {
+			bnb = true;
+			bnbParams.timeLimit = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-bnbmem") == 0 && i + 1 < argc) {
+			bnbParams.memoryLimit = atoll(argv[++i]) << 20;
+		}
+		else if (strcmp(argv[i], "-threads") == 0 && i + 1 < argc) {
+			bnbParams.threads = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-deterministic") == 0 && i + 1 < argc) {
+			bnbParams.deterministic = true;
+			bnbParams.batchSize = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-bnbnodes") == 0 && i + 1 < argc) {
+			bnbParams.nodeLimit = atoll(argv[++i]);
+		}
+		else {
+			std::cout << "unknown option: " << argv[i] << std::endl;
+			return -1;
+		}
+	}
 	int instanceNameLength = 0;
 
 	bool ok = true;
 	while (ok) {
-		if (instanceName[instanceNameLength] == '.')
+		if (instanceName[instanceNameLength] == '.' || instanceName[instanceNameLength] == '\0')
 			ok = false;
 		else
 			instanceNameLength++;
@@ -47,37 +227,262 @@ int main(int argc, char **argv)
 
 	clock_t start, end;
 	double time;
-	
-	char modelFilename[200];
-	char logFilename[200];
+
+	/* -compress without the options that read the ints (-warmstart, -decompose, -bnb, -colgen, -strategy, the full
+	 * dump): each row of profits is compressed as it is read, so the n*m ints are never in memory
+	 * */
+	CompressedProfits profitStore;
+	bool compressRead = compress && warmStartFilename == NULL && !decompose && !bnb && columnGeneration == 0 && !strategy && verbosity < PRINT_FULL;
 
 	// read file
-	int status = readInstance(instanceName, n, m, r, weights, capacities, profits, classes, indexes, setups, b);
+	int status = compressRead ? readInstanceCompressed(instanceName, n, m, r, weights, capacities, profitStore, classes, indexes, setups, b) : readInstance(instanceName, n, m, r, weights, capacities, profits, classes, indexes, setups, b);
 	if (status) {
 		std::cout << "File not found or not read correctly" << std::endl;
 		return -3;
 	}
 
 	// model into a .lp file
-	strcpy(modelFilename, "models/");
-	strncat(modelFilename, instanceName, instanceNameLength);
-	strcat(modelFilename, ".lp");
+	std::string modelFilename = "models/" + std::string(instanceName, instanceNameLength) + ".lp";
 
 	// log into a .txt file
-	strcpy(logFilename, "logs/");
-	strncat(logFilename, instanceName, instanceNameLength);
-	strcat(logFilename, ".txt");
+	std::string logFilename = "logs/" + std::string(instanceName, instanceNameLength) + ".txt";
+
+	if (verbosity >= PRINT_FULL)
+		printInstance(n, m, r, weights, capacities, profits, classes, indexes, setups, b);
+	else if (verbosity == PRINT_SUMMARY)
+		printInstanceSummary(n, m, r, weights, capacities, indexes, setups, b);
+
+	// the strategy replaces -subsolver, -colgen, -decompose and -buildthreads
+	if (strategy) {
+		InstanceFeatures features;
+		computeFeatures(n, m, r, b, weights, profits, capacities, setups, indexes, features);
+		printFeatures(features);
+		Strategy chosen;
+		if (strategyKind == STRATEGY_AUTO)
+			selectStrategy(features, chosen);
+		else
+			fixedStrategy(strategyKind, features, chosen);
+		std::cout << "Strategy: " << strategyName(chosen.kind);
+		if (chosen.rule != NULL)
+			std::cout << " (rule: " << chosen.rule << ")";
+		std::cout << ", threads " << chosen.threads << std::endl;
+
+		exactSubproblems = chosen.kind != STRATEGY_NO_SUBSOLVER;
+		columnGeneration = chosen.columnGeneration;
+		decompose = chosen.kind == STRATEGY_DECOMPOSE;
+		if (decompose) {
+			decomposeParams.parts = chosen.parts;
+			decomposeParams.threads = chosen.threads;
+		}
+		else {
+			buildThreads = chosen.threads;
+		}
+	}
+
+	RunReport *report = NULL;
+	if (traceFilename != NULL) {
+		report = new RunReport(traceFilename);
+		if (!report->isOpen()) {
+			std::cout << "Trace file not opened: " << traceFilename << std::endl;
+			delete report;
+			report = NULL;
+		}
+	}
+
+	Solution solution;
+	initSolution(solution, n, m, r);
+
+	SolutionPool pool;
+	if (poolSize > 0)
+		initPool(pool, poolSize, n, m, r);
+
+	// warm start: best solution of the file, mapped on this instance and repaired
+	Solution warmStart;
+	bool warm = false;
+	if (warmStartFilename != NULL) {
+		Solution *prior;
+		int count;
+		if (readSolutions(warmStartFilename, prior, count) || count == 0) {
+			std::cout << "Warm start not read: " << warmStartFilename << std::endl;
+		}
+		else {
+			initSolution(warmStart, n, m, r);
+			mapSolution(prior[0], warmStart, profits, classes, indexes);
+			int removed = repairSolution(warmStart, b, weights, profits, capacities, setups, classes, indexes);
+			std::cout << "Warm start: " << warmStart.objval << " (" << removed << " items removed by the repair)" << std::endl;
+			warm = true;
+		}
+		freeSolutions(prior, count);
+	}
+
+	// peak memory of the formulation given by the options, estimated before anything large is allocated
+	int formulation = decompose ? MEMORY_DECOMPOSE : compress && !warm && !bnb && columnGeneration == 0 ? MEMORY_COMPRESSED : MEMORY_FULL;
+	long long memoryEstimate;
+	if (compressRead) {
+		MemoryEstimate model;
+		estimateModel(n, m, r, compressedBytes(profitStore), model);
+		memoryEstimate = model.peak;
+	}
+	else {
+		memoryEstimate = estimateFormulation(formulation, n, m, r, profits, indexes, decomposeParams.parts, decomposeParams.threads, bnb ? bnbParams.threads : 0, bnbParams.memoryLimit);
+	}
+	std::cout << "Memory estimate: " << memoryEstimate / 1048576.0 << " MB (" << memoryFormulationName(formulation) << ")" << std::endl;
+	// with the branch and bound the open nodes are always kept within the limit
+	if (memoryLimit > 0 && (memoryEstimate > memoryLimit || bnb)) {
+		// the warm start, the branch and bound and the column generation need the ints, the decomposition drops the warm start and the branch and bound
+		MemoryPlan plan;
+		bool fits;
+		if (compressRead) {
+			// the ints of the decomposition are no longer there
+			plan.formulation = MEMORY_COMPRESSED;
+			plan.estimate = memoryEstimate;
+			fits = false;
+		}
+		else {
+			fits = planMemory(memoryLimit, n, m, r, profits, indexes, !warm && !bnb && columnGeneration == 0, !warm && !bnb, bnb ? bnbParams.threads : 0, bnbParams.memoryLimit, plan);
+		}
+		if (!fits) {
+			std::cerr << "error: GMKP estimated peak memory " << plan.estimate / 1048576.0 << " MB at least (" << memoryFormulationName(plan.formulation) << "), above the limit of " << memoryLimit / 1048576.0 << " MB" << std::endl;
+			if (report != NULL) {
+				report->close();
+				delete report;
+			}
+			if (warm)
+				freeSolution(warmStart);
+			freeSolution(solution);
+			if (poolSize > 0)
+				freePool(pool);
+			free(b);
+			free(profits);
+			free(weights);
+			free(capacities);
+			free(setups);
+			free(classes);
+			free(indexes);
+			return -4;
+		}
+		formulation = plan.formulation;
+		memoryEstimate = plan.estimate;
+		compress = formulation == MEMORY_COMPRESSED;
+		decompose = formulation == MEMORY_DECOMPOSE;
+		if (decompose) {
+			decomposeParams.parts = plan.parts;
+			decomposeParams.threads = plan.threads;
+			std::cout << "Memory limit: " << plan.parts << " parts, " << plan.threads << " at the same time, estimated " << memoryEstimate / 1048576.0 << " MB" << std::endl;
+		}
+		else if (bnb) {
+			bnbParams.threads = plan.bnbThreads;
+			bnbParams.memoryLimit = plan.bnbMemory;
+			std::cout << "Memory limit: branch and bound with " << plan.bnbThreads << " threads and " << plan.bnbMemory / 1048576.0 << " MB of nodes, estimated " << memoryEstimate / 1048576.0 << " MB" << std::endl;
+		}
+		else {
+			std::cout << "Memory limit: " << memoryFormulationName(formulation) << ", estimated " << memoryEstimate / 1048576.0 << " MB" << std::endl;
+		}
+	}
+
+	SolveParameters params;
+	initSolveParameters(params);
+	params.modelFilename = modelFilename.data();
+	params.logFilename = logFilename.data();
+	params.journalFilename = journalFilename;
+	params.TL = TL;
+	params.report = report;
+	params.pool = poolSize > 0 ? &pool : NULL;
+	params.warmStart = warm ? &warmStart : NULL;
+	params.exactSubproblems = exactSubproblems;
+	params.integralityTolerance = integralityTolerance;
+	params.columnGeneration = columnGeneration;
+	params.columnBatch = columnBatch;
+	params.symmetry = symmetry;
+	ParallelPlan plan;
+	initParallelPlan(plan, buildThreads);
+	params.parallel = &plan;
+	DiveStatistics stats;
+	params.stats = &stats;
+
+	// compressed profits: the ints are freed (or were never read), the dive reads the compressed rows
+	if (compress && (warm || decompose || bnb || columnGeneration > 0)) {
+		std::cout << "Compressed profits not used with -warmstart, -decompose, -bnb or -colgen" << std::endl;
+	}
+	else if (compress) {
+		if (!compressRead) {
+			compressProfits(n, m, profits, &plan, profitStore);
+			free(profits);
+			profits = NULL;
+		}
+		std::cout << "Compressed profits: " << compressedBytes(profitStore) / 1048576.0 << " MB (" << (double)n * m * sizeof(int) / 1048576.0 << " MB as ints)" << std::endl;
+		params.profitStore = &profitStore;
+	}
+
+	PerfCounters counters;
+	if (perf) {
+		openPerfCounters(counters);
+		params.perf = &counters;
+	}
+
+	if (decompose) {
+		decomposeParams.TL = TL;
+		decomposeParams.exactSubproblems = exactSubproblems;
+		DecomposeResult decomposed;
+		status = solveDecomposed(n, m, r, b, weights, profits, capacities, setups, classes, indexes, decomposeParams, solution, decomposed);
+		std::cout << "Decomposition: " << decomposed.parts << " parts, merged " << decomposed.mergedObjval << ", improved " << solution.objval << " (" << decomposed.addedItems << " items added, " << decomposed.openedClasses << " classes opened), dives " << decomposed.solveTime << ", improvement " << decomposed.improveTime << std::endl;
 
-	printInstance(n, m, r, weights, capacities, profits, classes, indexes, setups, b);
+		if (compare && status == 0) {
+			Solution whole;
+			initSolution(whole, n, m, r);
+			double start = wallClock();
+			params.verbose = false;
+			status = solve(n, m, r, b, weights, profits, capacities, setups, classes, indexes, params, whole);
+			std::cout << "Whole instance: " << whole.objval << ", time " << wallClock() - start << ", gap of the decomposition " << (whole.objval > 0 ? (whole.objval - solution.objval) / whole.objval * 100 : 0) << "%" << std::endl;
+			freeSolution(whole);
+		}
+	}
+	else {
+		status = solve(n, m, r, b, weights, profits, capacities, setups, classes, indexes, params, solution);
+	}
 
-	status = solve(n, m, r, b, weights, profits, capacities, setups, classes, indexes, modelFilename, logFilename, TL);
+	if (warm)
+		freeSolution(warmStart);
+
+	// the solution of the dive is the first incumbent
+	if (bnb && status == 0) {
+		BranchAndBoundResult result;
+		status = branchAndBound(n, m, r, b, weights, profits, capacities, setups, classes, indexes, bnbParams, solution, result, report);
+		std::cout << "Branch and bound: incumbent " << result.incumbent << ", bound " << result.bound << ", gap " << result.gap * 100 << "%, nodes " << result.nodes << ", open nodes " << result.openNodes << (result.optimal ? " (optimal)" : "") << (result.memoryLimitReached ? " (memory limit reached)" : "") << std::endl;
+	}
+
+	if (perf) {
+		closePerfCounters(counters);
+		printPerfCounters(counters);
+		if (report != NULL)
+			report->perf(counters);
+	}
+
+	if (report != NULL) {
+		report->close();
+		delete report;
+	}
 
 	// print output
 	if (status)
-		std::cout << "An error has occurred! Error number : " << status << std::endl;
+		std::cout << "An error has occurred! Error number : " << status << " (" << gmkpErrorString(status) << ")" << std::endl;
 	else
 		std::cout << "The function was performed correctly!" << std::endl;
 
+	std::cout << "Solution: " << solution.objval << (solution.status == 0 ? " (feasible)" : " (not feasible)") << std::endl;
+	std::cout << "Peak memory: " << peakMemory() / 1048576.0 << " MB (estimated " << memoryEstimate / 1048576.0 << " MB)" << std::endl;
+
+	if (solutionFilename != NULL && writeSolutions(solutionFilename, &solution, 1))
+		std::cout << "Solution not written: " << solutionFilename << std::endl;
+
+	if (poolSize > 0) {
+		std::cout << "Pool: " << pool.size << " feasible solutions" << std::endl;
+		if (writeSolutions(poolFilename, pool.solutions, pool.size))
+			std::cout << "Pool not written: " << poolFilename << std::endl;
+		freePool(pool);
+	}
+	freeSolution(solution);
+
 	// free memory
 	free(b);
 	free(profits);
@@ -87,5 +492,389 @@ int main(int argc, char **argv)
 	free(classes);
 	free(indexes);
 
+	// the GMKP_ERROR code of the solve, so scripts detect a failed run
+	return status;
+}
+
+// generate a random instance into the instances directory
+int generate(int argc, char **argv)
+{
+	if (argc < 7) {
+		std::cout << "invalid parameters!\n";
+		std::cout << "parameters: -generate [nameInstance] [n] [m] [r] [seed]\n";
+		std::cout << "options: -classes uniform|random|skewed\n";
+		std::cout << "         -profits uncorrelated|weak|strong\n";
+		std::cout << "         -tightness [value]\n";
+		std::cout << "         -b [min] [max]\n";
+		std::cout << "         -weights [min] [max]\n";
+		std::cout << "         -range [min] [max] (uncorrelated profits)\n";
+		return -1;
+	}
+
+	GeneratorParameters params;
+	initGeneratorParameters(params);
+
+	char *instanceName = argv[2];
+	params.n = atoi(argv[3]);
+	params.m = atoi(argv[4]);
+	params.r = atoi(argv[5]);
+	params.seed = strtoull(argv[6], NULL, 10);
+
+	for (int i = 7; i < argc; i++) {
+		if (strcmp(argv[i], "-classes") == 0 && i + 1 < argc) {
+			i++;
+			if (strcmp(argv[i], "uniform") == 0)
+				params.classDistribution = CLASSES_UNIFORM;
+			else if (strcmp(argv[i], "skewed") == 0)
+				params.classDistribution = CLASSES_SKEWED;
+			else
+				params.classDistribution = CLASSES_RANDOM;
+		}
+		else if (strcmp(argv[i], "-profits") == 0 && i + 1 < argc) {
+			i++;
+			if (strcmp(argv[i], "weak") == 0)
+				params.profitCorrelation = PROFITS_WEAKLY_CORRELATED;
+			else if (strcmp(argv[i], "strong") == 0)
+				params.profitCorrelation = PROFITS_STRONGLY_CORRELATED;
+			else
+				params.profitCorrelation = PROFITS_UNCORRELATED;
+		}
+		else if (strcmp(argv[i], "-tightness") == 0 && i + 1 < argc) {
+			params.tightness = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-b") == 0 && i + 2 < argc) {
+			params.bMin = atoi(argv[++i]);
+			params.bMax = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-weights") == 0 && i + 2 < argc) {
+			params.wMin = atoi(argv[++i]);
+			params.wMax = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-range") == 0 && i + 2 < argc) {
+			params.pMin = atoi(argv[++i]);
+			params.pMax = atoi(argv[++i]);
+		}
+		else {
+			std::cout << "unknown option: " << argv[i] << std::endl;
+			return -1;
+		}
+	}
+
+	clock_t start = clock();
+	int status = generateInstance(instanceName, params);
+	clock_t end = clock();
+
+	if (status) {
+		std::cout << "Instance not generated! Error number : " << status << std::endl;
+		return -2;
+	}
+
+	std::cout << "Instance generated: " << instanceName << " (n = " << params.n << ", m = " << params.m << ", r = " << params.r << ", seed = " << params.seed << ")" << std::endl;
+	std::cout << "Elapsed time: " << ((double)(end - start)) / CLOCKS_PER_SEC << std::endl;
+
 	return 0;
-}
\ No newline at end of file
+}
+
+// serve the instances received on a Unix domain socket
+int serve(int argc, char **argv)
+{
+	if (argc < 3) {
+		std::cout << "invalid parameters!\n";
+		std::cout << "parameters: -server [socket]\n";
+		std::cout << "options: -workers [k] (threads, each with its own CPLEX environment, default 1)\n";
+		std::cout << "         -timelimit [seconds] (time limit of the requests without their own, default 10)\n";
+		std::cout << "         -subsolver 0|1 (exact knapsack subsolver when all y are fixed, default 1)\n";
+		std::cout << "         -iotimeout [seconds] (wait of a read or a write on a connection at most, default 30)\n";
+		return -1;
+	}
+
+	ServerParameters params;
+	initServerParameters(params);
+	params.socketPath = argv[2];
+
+	for (int i = 3; i < argc; i++) {
+		if (strcmp(argv[i], "-workers") == 0 && i + 1 < argc) {
+			params.workers = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-timelimit") == 0 && i + 1 < argc) {
+			params.timeLimit = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-subsolver") == 0 && i + 1 < argc) {
+			params.exactSubproblems = atoi(argv[++i]) != 0;
+		}
+		else if (strcmp(argv[i], "-iotimeout") == 0 && i + 1 < argc) {
+			params.ioTimeout = atof(argv[++i]);
+		}
+		else {
+			std::cout << "unknown option: " << argv[i] << std::endl;
+			return -1;
+		}
+	}
+
+	return runServer(params);
+}
+
+// send an instance file to the server and print the response
+int client(int argc, char **argv)
+{
+	if (argc < 4) {
+		std::cout << "invalid parameters!\n";
+		std::cout << "parameters: -client [socket] [instanceFile] [timeout]\n";
+		std::cout << "            -client [socket] -shutdown\n";
+		return -1;
+	}
+
+	bool shutdown = strcmp(argv[3], "-shutdown") == 0;
+	double timeLimit = argc >= 5 ? atof(argv[4]) : 0;
+
+	std::string response;
+	int status = runClient(argv[2], shutdown ? NULL : argv[3], timeLimit, response);
+	if (status == 1) {
+		std::cout << "File not found: " << argv[3] << std::endl;
+	}
+	else if (status == 2) {
+		std::cout << "Server not reachable: " << argv[2] << std::endl;
+	}
+	else {
+		std::cout << response;
+		if (status == 3)
+			std::cout << "Connection closed before the end of the response" << std::endl;
+	}
+
+	return status;
+}
+
+// model build and checker with 1, 2, 4, ... threads up to all the cores
+int scaling(int argc, char **argv)
+{
+	if (argc < 3) {
+		std::cout << "invalid parameters!\n";
+		std::cout << "parameters: -scaling [nameInstance]\n";
+		return -1;
+	}
+
+	int n, m, r;
+	int *b = NULL, *profits = NULL, *weights = NULL, *capacities = NULL, *setups = NULL, *classes = NULL, *indexes = NULL;
+	if (readInstance(argv[2], n, m, r, weights, capacities, profits, classes, indexes, setups, b)) {
+		std::cout << "File not found or not read correctly" << std::endl;
+		return -3;
+	}
+
+	ParallelPlan all;
+	initParallelPlan(all, 0);
+	std::cout << "Instance: " << argv[2] << " (n * m = " << (long long)n * m << "), cores: " << all.threads << ", NUMA nodes: " << all.nodes << std::endl;
+
+	int status = 0;
+	CPXENVptr env = CPXopenCPLEX(&status);
+	if (status) {
+		std::cerr << "error: GMKP CPXopenCPLEX failed" << std::endl;
+		return -1;
+	}
+
+	// the checker scans all x when nothing is violated
+	double *x = new double[(size_t)n * m + m * r]();
+
+	std::cout << "threads,nodes,build,check,build speedup,check speedup" << std::endl;
+	double build1 = 0, check1 = 0;
+	for (int threads = 1; status == 0; threads = threads * 2 < all.threads ? threads * 2 : all.threads) {
+		ParallelPlan plan;
+		initParallelPlan(plan, threads);
+
+		CPXLPptr lp = CPXcreateprob(env, &status, "GMKP - Callable Library");
+		if (status) {
+			std::cerr << "error: GMKP CPXcreateprob failed" << std::endl;
+			break;
+		}
+		double start = wallClock();
+		status = buildModel(env, lp, n, m, r, b, weights, profits, capacities, setups, classes, indexes, &plan, NULL);
+		double build = wallClock() - start;
+		CPXfreeprob(env, &lp);
+
+		// best of three
+		double check = 0;
+		for (int t = 0; t < 3; t++) {
+			start = wallClock();
+			checkSolutionParallel(&plan, x, 0, n, m, r, b, weights, profits, capacities, setups, classes, indexes);
+			double time = wallClock() - start;
+			if (t == 0 || time < check)
+				check = time;
+		}
+
+		if (threads == 1) {
+			build1 = build;
+			check1 = check;
+		}
+		std::cout << threads << "," << plan.nodes << "," << build << "," << check << "," << build1 / build << "," << check1 / check << std::endl;
+
+		if (threads == all.threads)
+			break;
+	}
+
+	delete[] x;
+	CPXcloseCPLEX(&env);
+	free(b);
+	free(profits);
+	free(weights);
+	free(capacities);
+	free(setups);
+	free(classes);
+	free(indexes);
+
+	return status;
+}
+
+// solve all the instances of a directory of ./instances, overlapping the parse, the build and the solve of different instances
+int batch(int argc, char **argv)
+{
+	if (argc < 4) {
+		std::cout << "invalid parameters!\n";
+		std::cout << "parameters: -batch [directory] [timeout] [options]\n";
+		std::cout << "options: -parsers [k] (threads reading the instances ahead, default 1)\n";
+		std::cout << "         -builders [k] (threads building the models, default 1)\n";
+		std::cout << "         -solvers [k] (threads running the dive, default 1)\n";
+		std::cout << "         -queue [k] (instances waiting between two stages at most, default 2)\n";
+		std::cout << "         -results [file.csv] (one line for each instance)\n";
+		std::cout << "         -subsolver 0|1 (exact knapsack subsolver when all y are fixed, default 1)\n";
+		return -1;
+	}
+
+	BatchParameters params;
+	initBatchParameters(params);
+	params.timeLimit = atof(argv[3]);
+
+	for (int i = 4; i < argc; i++) {
+		if (strcmp(argv[i], "-parsers") == 0 && i + 1 < argc) {
+			params.parsers = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-builders") == 0 && i + 1 < argc) {
+			params.builders = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-solvers") == 0 && i + 1 < argc) {
+			params.solvers = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-queue") == 0 && i + 1 < argc) {
+			params.queueSize = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-results") == 0 && i + 1 < argc) {
+			params.resultFilename = argv[++i];
+		}
+		else if (strcmp(argv[i], "-subsolver") == 0 && i + 1 < argc) {
+			params.exactSubproblems = atoi(argv[++i]) != 0;
+		}
+		else {
+			std::cout << "unknown option: " << argv[i] << std::endl;
+			return -1;
+		}
+	}
+
+	std::vector<std::string> names;
+	if (listInstances(argv[2], names)) {
+		std::cout << "Directory not found: ./instances/" << argv[2] << std::endl;
+		return -3;
+	}
+
+	std::cout << "Batch of " << names.size() << " instances: " << params.parsers << " parsers, " << params.builders << " builders, " << params.solvers << " solvers, queues of " << params.queueSize << std::endl;
+	return runBatch(params, names) > 0 ? -2 : 0;
+}
+
+// regression harness: the dive on a fixed corpus, compared with the results of a previous run
+int bench(int argc, char **argv)
+{
+	if (argc < 3) {
+		std::cout << "invalid parameters!\n";
+		std::cout << "parameters: -bench [timeout] [options]\n";
+		std::cout << "options: -corpus [directory] (corpus in ./instances/directory, generated if missing, default bench)\n";
+		std::cout << "         -maxsize small|medium|large (instances of the corpus up to this size, default medium)\n";
+		std::cout << "         -iterations [k] (iterations of the dive for each instance, default 0: up to the timeout)\n";
+		std::cout << "         -baseline [file.csv] (results of a previous run to compare with)\n";
+		std::cout << "         -results [file.csv] (results of this run, to be used as a baseline)\n";
+		std::cout << "         -objtol [fraction] (loss of objective allowed, default 0.001)\n";
+		std::cout << "         -lptol [fraction] (increase of LPs allowed, default 0.1)\n";
+		std::cout << "         -timetol [fraction] (increase of wall time allowed, default 0.25)\n";
+		std::cout << "         -timeslack [seconds] (increase of wall time always allowed, default 0.5)\n";
+		return -1;
+	}
+
+	BenchParameters params;
+	initBenchParameters(params);
+	params.timeLimit = atoi(argv[2]);
+
+	for (int i = 3; i < argc; i++) {
+		if (strcmp(argv[i], "-corpus") == 0 && i + 1 < argc) {
+			params.directory = argv[++i];
+		}
+		else if (strcmp(argv[i], "-maxsize") == 0 && i + 1 < argc) {
+			i++;
+			if (strcmp(argv[i], "small") == 0)
+				params.maxSize = BENCH_SMALL;
+			else if (strcmp(argv[i], "medium") == 0)
+				params.maxSize = BENCH_MEDIUM;
+			else if (strcmp(argv[i], "large") == 0)
+				params.maxSize = BENCH_LARGE;
+			else {
+				std::cout << "unknown size: " << argv[i] << std::endl;
+				return -1;
+			}
+		}
+		else if (strcmp(argv[i], "-iterations") == 0 && i + 1 < argc) {
+			params.iterationLimit = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-baseline") == 0 && i + 1 < argc) {
+			params.baselineFilename = argv[++i];
+		}
+		else if (strcmp(argv[i], "-results") == 0 && i + 1 < argc) {
+			params.resultFilename = argv[++i];
+		}
+		else if (strcmp(argv[i], "-objtol") == 0 && i + 1 < argc) {
+			params.objectiveTolerance = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-lptol") == 0 && i + 1 < argc) {
+			params.lpTolerance = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-timetol") == 0 && i + 1 < argc) {
+			params.timeTolerance = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "-timeslack") == 0 && i + 1 < argc) {
+			params.timeSlack = atof(argv[++i]);
+		}
+		else {
+			std::cout << "unknown option: " << argv[i] << std::endl;
+			return -1;
+		}
+	}
+
+	// exit code: 0 if nothing got worse
+	int regressions = runBench(params);
+	return regressions < 0 ? -3 : (regressions > 0 ? 1 : 0);
+}
+
+int replay(int argc, char **argv)
+{
+	if (argc < 3) {
+		std::cout << "invalid parameters!\n";
+		std::cout << "parameters: -replay [journal] [lp] [model]\n";
+		std::cout << "lp: LP of the dive to rebuild (default 0: the last one), model: file of the rebuilt lp (default: not written)\n";
+		return -1;
+	}
+
+	int lp = argc >= 4 ? atoi(argv[3]) : 0;
+	char *modelFilename = argc >= 5 ? argv[4] : NULL;
+	return replayJournal(argv[2], lp, modelFilename) ? -3 : 0;
+}
+
+// every strategy on all the instances of a directory, compared with the automatic choice
+int strategies(int argc, char **argv)
+{
+	if (argc < 4) {
+		std::cout << "invalid parameters!\n";
+		std::cout << "parameters: -strategies [directory] [timeout]\n";
+		return -1;
+	}
+
+	int errors = runStrategyBench(argv[2], atof(argv[3]));
+	if (errors < 0) {
+		std::cout << "Directory not found: ./instances/" << argv[2] << std::endl;
+		return -3;
+	}
+	return errors > 0 ? -2 : 0;
+}
@@ -1,13 +1,97 @@
 #include "INSTANCE.h"
 
 void tokenize(std::string const &str, const char delim, std::vector<std::string> &out);
+bool readField(const std::vector<std::string> &tokens, size_t position, int &value);
 void addItemInClass(int r, int n, int class_gen, int item, int * indexes, int * classes);
+int readInstanceFile(char *file_name, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b, CompressedProfits *store);
+int readInstanceText(std::istream &file, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b, CompressedProfits *store);
+int parseInstanceText(std::istream &file, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b, CompressedProfits *store);
+int readInstanceBinary(FILE *file, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b, CompressedProfits *store);
+int parseInstanceBinary(FILE *file, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b, CompressedProfits *store);
+
+int readInstanceFile(char *file_name, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b, CompressedProfits *store) {
+
+	// names of any length (batch, bench and strategy lists)
+	std::string path = std::string("./instances/") + file_name;
+
+	size_t length = strlen(file_name);
+	if (length > 4 && strcmp(file_name + length - 4, ".bin") == 0) {
+		FILE *file = fopen(path.c_str(), "rb");
+		if (file == NULL)
+			return 1;
+		int status = readInstanceBinary(file, n, m, r, weights, capacities, profits, classes, indexes, setups, b, store);
+		fclose(file);
+		return status;
+	}
+
+	std::ifstream file(path.c_str());
+	if (!file.is_open()) {
+		std::cout << "Parameters: " << std::endl;
+		return 1;
+	}
+	int status = readInstanceText(file, n, m, r, weights, capacities, profits, classes, indexes, setups, b, store);
+	file.close();
+	return status;
+}
 
 int readInstance(char *file_name, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b) {
+	return readInstanceFile(file_name, n, m, r, weights, capacities, profits, classes, indexes, setups, b, NULL);
+}
+
+int readInstanceCompressed(char *file_name, int& n, int& m, int& r, int * &weights, int * &capacities, CompressedProfits &store, int * &classes, int * &indexes, int * &setups, int * &b) {
+	int *profits = NULL;
+	return readInstanceFile(file_name, n, m, r, weights, capacities, profits, classes, indexes, setups, b, &store);
+}
+
+int readInstanceData(const char *data, size_t size, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b) {
+
+	if (size >= 8 && memcmp(data, BINARY_INSTANCE_MAGIC, 8) == 0) {
+		FILE *file = fmemopen((void *)data, size, "rb");
+		if (file == NULL)
+			return 1;
+		int status = readInstanceBinary(file, n, m, r, weights, capacities, profits, classes, indexes, setups, b, NULL);
+		fclose(file);
+		return status;
+	}
+
+	std::istringstream file(std::string(data, size));
+	return readInstanceText(file, n, m, r, weights, capacities, profits, classes, indexes, setups, b, NULL);
+}
+
+bool validInstanceSizes(int n, int m, int r) {
+	long long nm = (long long)n * m;
+	return nm + (long long)m * r <= INT_MAX && nm + n + m + r <= INT_MAX;
+}
 
-	char path[200];
-	strcpy(path, "./instances/");
-	strcat(path, file_name);
+void freeInstanceArrays(int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b) {
+	free(weights);
+	free(capacities);
+	free(profits);
+	free(classes);
+	free(indexes);
+	free(setups);
+	free(b);
+	weights = capacities = profits = classes = indexes = setups = b = NULL;
+}
+
+// the arrays allocated by a parse that fails are freed here, whatever line it stopped at
+int readInstanceText(std::istream &file, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b, CompressedProfits *store) {
+	weights = capacities = profits = classes = indexes = setups = b = NULL;
+	int status = parseInstanceText(file, n, m, r, weights, capacities, profits, classes, indexes, setups, b, store);
+	if (status)
+		freeInstanceArrays(weights, capacities, profits, classes, indexes, setups, b);
+	return status;
+}
+
+int readInstanceBinary(FILE *file, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b, CompressedProfits *store) {
+	weights = capacities = profits = classes = indexes = setups = b = NULL;
+	int status = parseInstanceBinary(file, n, m, r, weights, capacities, profits, classes, indexes, setups, b, store);
+	if (status)
+		freeInstanceArrays(weights, capacities, profits, classes, indexes, setups, b);
+	return status;
+}
+
+int parseInstanceText(std::istream &file, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b, CompressedProfits *store) {
 
 	const char delim = '\t';
 	bool nFind = false;
@@ -23,36 +107,47 @@ int readInstance(char *file_name, int& n, int& m, int& r, int * &weights, int *
 	int mCheck = 0;
 	int rCheck = 0;
 
-	std::ifstream file(path);
-	if (file.is_open()) {
+	{
 		std::string line;
 		getline(file, line); // read first line
 		while (getline(file, line)) {
 
 			std::vector<std::string> out;
 			tokenize(line, delim, out);
+			if (out.empty())
+				continue;
 			
+			// each size once, positive and indexable with the ones read before, before its arrays are allocated
 			if (strcmp("j items", out[0].c_str()) == 0) {
-				n = strtol(out[1].c_str(), NULL, 10);
+				if (nFind || !readField(out, 1, n) || n < 1 || !validInstanceSizes(n, mFind ? m : 0, rFind ? r : 0))
+					return 1;
 				nFind = true;
 				classes = (int *)malloc(sizeof(int) * n);
 				weights = (int *)malloc(sizeof(int) * n);
-				if (mFind && nFind)
-					profits = (int *)malloc(sizeof(int) * n * m);
+				if (classes == NULL || weights == NULL)
+					return 1;
+				if (mFind && nFind && store == NULL && (profits = (int *)malloc(sizeof(int) * (size_t)n * m)) == NULL)
+					return 1;
 			}
 			else if (strcmp("k knapsacks", out[0].c_str()) == 0) {
-				m = strtol(out[1].c_str(), NULL, 10);
+				if (mFind || !readField(out, 1, m) || m < 1 || !validInstanceSizes(nFind ? n : 0, m, rFind ? r : 0))
+					return 1;
 				mFind = true;
 				capacities = (int *)malloc(sizeof(int) * m);
-				if (mFind && nFind)
-					profits = (int *)malloc(sizeof(int) * n * m);
+				if (capacities == NULL)
+					return 1;
+				if (mFind && nFind && store == NULL && (profits = (int *)malloc(sizeof(int) * (size_t)n * m)) == NULL)
+					return 1;
 			}
 			else if (strcmp("r classes", out[0].c_str()) == 0) {
-				r = strtol(out[1].c_str(), NULL, 10);
+				if (rFind || !readField(out, 1, r) || r < 1 || !validInstanceSizes(nFind ? n : 0, mFind ? m : 0, r))
+					return 1;
 				rFind = true;
 				b = (int *)malloc(sizeof(int) * r);
 				setups = (int *)malloc(sizeof(int) * r);
 				indexes = (int *)malloc(sizeof(int) * r);
+				if (b == NULL || setups == NULL || indexes == NULL)
+					return 1;
 			}
 			else if (strcmp("parameter w(j)", out[0].c_str()) == 0 && nFind) {
 
@@ -60,9 +155,14 @@ int readInstance(char *file_name, int& n, int& m, int& r, int * &weights, int *
 					std::vector<std::string> out2;
 					tokenize(line, delim, out2);
 
-					weights[nCheck++] = strtol(out2[1].c_str(), NULL, 10);
+					int j, value;
+					if (nCheck >= n)
+						return 3;
+					if (!readField(out2, 0, j) || !readField(out2, 1, value))
+						return 2;
+					weights[nCheck++] = value;
 
-					if (nCheck != strtol(out2[0].c_str(), NULL, 10))
+					if (nCheck != j)
 						return 2;
 				}
 
@@ -78,9 +178,14 @@ int readInstance(char *file_name, int& n, int& m, int& r, int * &weights, int *
 					std::vector<std::string> out2;
 					tokenize(line, delim, out2);
 
-					capacities[mCheck++] = strtol(out2[1].c_str(), NULL, 10);
+					int i, value;
+					if (mCheck >= m)
+						return 3;
+					if (!readField(out2, 0, i) || !readField(out2, 1, value))
+						return 2;
+					capacities[mCheck++] = value;
 
-					if (mCheck != strtol(out2[0].c_str(), NULL, 10))
+					if (mCheck != i)
 						return 2;
 				}
 
@@ -94,17 +199,34 @@ int readInstance(char *file_name, int& n, int& m, int& r, int * &weights, int *
 				
 				nCheck = 0;
 				mCheck = 0;
+				// compressed: the row being read, appended once complete
+				std::vector<int> row;
+				if (store != NULL) {
+					initCompressedProfits(n, m, *store);
+					row.resize(n);
+				}
 				while (getline(file, line) && strcmp(line.c_str(), "") != 0) {
 					std::vector<std::string> out2;
 					tokenize(line, delim, out2);
 
-					profits[nCheck++ + mCheck*n] = strtol(out2[2].c_str(), NULL, 10);
+					int j, i, value;
+					if (nCheck >= n)
+						return 3;
+					if (!readField(out2, 0, j) || !readField(out2, 1, i) || !readField(out2, 2, value))
+						return 2;
+					if (store != NULL)
+						row[nCheck++] = value;
+					else
+						profits[nCheck++ + mCheck*n] = value;
 
-					if (nCheck != strtol(out2[0].c_str(), NULL, 10))
+					if (nCheck != j)
 						return 2;
-					if (mCheck+1 != strtol(out2[1].c_str(), NULL, 10))
+					if (mCheck+1 != i)
 						return 2;
 
+					if (store != NULL && nCheck == n)
+						appendProfits(*store, row.data());
+
 					if (nCheck == n && (mCheck+1) != m) {
 						nCheck = 0;
 						mCheck++;
@@ -119,6 +241,10 @@ int readInstance(char *file_name, int& n, int& m, int& r, int * &weights, int *
 			}
 			else if (strcmp("parameter t(r,j)", out[0].c_str()) == 0 && nFind && rFind) {
 
+				// every class needs an item
+				if (r > n)
+					return 4;
+
 				// initializate array
 				for (int i = 0; i < r; i++) {
 					classes[i] = -1;
@@ -130,10 +256,15 @@ int readInstance(char *file_name, int& n, int& m, int& r, int * &weights, int *
 					std::vector<std::string> out2;
 					tokenize(line, delim, out2);
 
-					addItemInClass(r, n, strtol(out2[1].c_str(), NULL, 10), nCheck, indexes, classes);
+					int j, k;
+					if (nCheck >= n)
+						return 3;
+					if (!readField(out2, 0, j) || !readField(out2, 1, k) || k < 1 || k > r)
+						return 2;
+					addItemInClass(r, n, k, nCheck, indexes, classes);
 					nCheck++;
 
-					if (nCheck != strtol(out2[0].c_str(), NULL, 10))
+					if (nCheck != j)
 						return 2;
 				}
 
@@ -155,9 +286,14 @@ int readInstance(char *file_name, int& n, int& m, int& r, int * &weights, int *
 					std::vector<std::string> out2;
 					tokenize(line, delim, out2);
 
-					setups[rCheck++] = strtol(out2[1].c_str(), NULL, 10);
+					int k, value;
+					if (rCheck >= r)
+						return 3;
+					if (!readField(out2, 0, k) || !readField(out2, 1, value))
+						return 2;
+					setups[rCheck++] = value;
 
-					if (rCheck != strtol(out2[0].c_str(), NULL, 10))
+					if (rCheck != k)
 						return 2;
 				}
 
@@ -174,9 +310,14 @@ int readInstance(char *file_name, int& n, int& m, int& r, int * &weights, int *
 					std::vector<std::string> out2;
 					tokenize(line, delim, out2);
 
-					b[rCheck++] = strtol(out2[1].c_str(), NULL, 10);
+					int k, value;
+					if (rCheck >= r)
+						return 3;
+					if (!readField(out2, 0, k) || !readField(out2, 1, value))
+						return 2;
+					b[rCheck++] = value;
 
-					if (rCheck != strtol(out2[0].c_str(), NULL, 10))
+					if (rCheck != k)
 						return 2;
 				}
 
@@ -188,10 +329,6 @@ int readInstance(char *file_name, int& n, int& m, int& r, int * &weights, int *
 			}
 
 		} // while getline
-		file.close();
-	}
-	else {
-		std::cout << "Parameters: " << std::endl;
 	}
 
 	if (!nFind || !mFind || !rFind || !weightsFind || !capacitiesFind || !profitsFind || !classesFind || !setupsFind || !bFind)
@@ -200,6 +337,99 @@ int readInstance(char *file_name, int& n, int& m, int& r, int * &weights, int *
 	return 0;
 }
 
+int parseInstanceBinary(FILE *file, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b, CompressedProfits *store) {
+
+	char magic[8];
+	int header[3];
+	if (fread(magic, 1, 8, file) != 8 || memcmp(magic, BINARY_INSTANCE_MAGIC, 8) != 0 || fread(header, sizeof(int), 3, file) != 3)
+		return 1;
+
+	n = header[0];
+	m = header[1];
+	r = header[2];
+	if (n < 1 || m < 1 || r < 1 || !validInstanceSizes(n, m, r))
+		return 1;
+
+	weights = (int *)malloc(sizeof(int) * n);
+	capacities = (int *)malloc(sizeof(int) * m);
+	// compressed: a single row of ints
+	profits = (int *)malloc(sizeof(int) * (store != NULL ? (size_t)n : (size_t)n * m));
+	classes = (int *)malloc(sizeof(int) * n);
+	indexes = (int *)malloc(sizeof(int) * r);
+	setups = (int *)malloc(sizeof(int) * r);
+	b = (int *)malloc(sizeof(int) * r);
+	if (weights == NULL || capacities == NULL || profits == NULL || classes == NULL || indexes == NULL || setups == NULL || b == NULL)
+		return 1;
+
+	// class of each item (temporarily stored in classes)
+	int *itemClass = (int *)malloc(sizeof(int) * n);
+	if (itemClass == NULL)
+		return 1;
+
+	size_t nm = (size_t)n * m;
+	bool ok = fread(weights, sizeof(int), n, file) == (size_t)n
+		&& fread(capacities, sizeof(int), m, file) == (size_t)m;
+	if (ok && store != NULL) {
+		initCompressedProfits(n, m, *store);
+		for (int i = 0; i < m && ok; i++) {
+			ok = fread(profits, sizeof(int), n, file) == (size_t)n;
+			if (ok)
+				appendProfits(*store, profits);
+		}
+		free(profits);
+		profits = NULL;
+	}
+	else if (ok) {
+		ok = fread(profits, sizeof(int), nm, file) == nm;
+	}
+	ok = ok
+		&& fread(itemClass, sizeof(int), n, file) == (size_t)n
+		&& fread(setups, sizeof(int), r, file) == (size_t)r
+		&& fread(b, sizeof(int), r, file) == (size_t)r;
+
+	if (!ok) {
+		free(itemClass);
+		return 3;
+	}
+
+	int status = groupItemsByClass(n, r, itemClass, classes, indexes);
+	free(itemClass);
+
+	return status;
+}
+
+int groupItemsByClass(int n, int r, const int *itemClass, int *classes, int *indexes) {
+
+	// counting sort of the items by class: same layout of addItemInClass, in O(n + r)
+	for (int k = 0; k < r; k++)
+		indexes[k] = 0;
+	for (int j = 0; j < n; j++) {
+		if (itemClass[j] < 0 || itemClass[j] >= r)
+			return 2;
+		indexes[itemClass[j]]++;
+	}
+
+	// check if class have at least one element
+	for (int k = 0; k < r; k++) {
+		if (indexes[k] == 0)
+			return 4;
+		indexes[k] += k > 0 ? indexes[k - 1] : 0;
+	}
+
+	// first free position of each class
+	int *next = (int *)malloc(sizeof(int) * r);
+	if (next == NULL)
+		return 1;
+	for (int k = 0; k < r; k++)
+		next[k] = k > 0 ? indexes[k - 1] : 0;
+	for (int j = 0; j < n; j++)
+		classes[next[itemClass[j]]++] = j;
+
+	free(next);
+
+	return 0;
+}
+
 void tokenize(std::string const &str, const char delim, std::vector<std::string> &out)
 {
 	size_t start;
@@ -212,6 +442,25 @@ void tokenize(std::string const &str, const char delim, std::vector<std::string>
 	}
 }
 
+// integer at position of tokens: false if it is missing, not a number or out of the range of an int
+bool readField(const std::vector<std::string> &tokens, size_t position, int &value) {
+	if (position >= tokens.size())
+		return false;
+	const char *text = tokens[position].c_str();
+	char *end;
+	errno = 0;
+	long number = strtol(text, &end, 10);
+	if (end == text || errno != 0 || number < INT_MIN || number > INT_MAX)
+		return false;
+	// trailing blanks (e.g. the \r of a file written on Windows) are allowed
+	while (*end == ' ' || *end == '\r')
+		end++;
+	if (*end != '\0')
+		return false;
+	value = (int)number;
+	return true;
+}
+
 void addItemInClass(int r, int n, int class_gen, int item, int * indexes, int * classes) {
 
 	for (int i = 0; i < r; i++) {
@@ -242,36 +491,113 @@ void addItemInClass(int r, int n, int class_gen, int item, int * indexes, int *
 
 }
 
+void printInstanceSummary(int n, int m, int r, int weights[], int capacities[], int indexes[], int setups[], int b[]) {
+
+	long long totalWeight = 0;
+	for (int j = 0; j < n; j++)
+		totalWeight += weights[j];
+
+	long long totalCapacity = 0;
+	int minCapacity = capacities[0];
+	int maxCapacity = capacities[0];
+	for (int i = 0; i < m; i++) {
+		totalCapacity += capacities[i];
+		if (capacities[i] < minCapacity)
+			minCapacity = capacities[i];
+		if (capacities[i] > maxCapacity)
+			maxCapacity = capacities[i];
+	}
+
+	long long totalSetup = 0;
+	long long totalB = 0;
+	for (int k = 0; k < r; k++) {
+		totalSetup += setups[k];
+		totalB += b[k];
+	}
+
+	// histogram of the class sizes: bucket h contains the classes with 2^h <= size < 2^(h+1)
+	const int buckets = 32;
+	int histogram[buckets] = { 0 };
+	int minSize = n;
+	int maxSize = 0;
+	for (int k = 0; k < r; k++) {
+		int size = findCardinalityOfClass(k, indexes);
+		int h = 0;
+		while ((size >> (h + 1)) > 0)
+			h++;
+		histogram[h]++;
+		if (size < minSize)
+			minSize = size;
+		if (size > maxSize)
+			maxSize = size;
+	}
+
+	std::cout << "Instance summary:" << "\n";
+	std::cout << "n = " << n << ", m = " << m << ", r = " << r << "\n";
+	std::cout << "c(i): min " << minCapacity << ", avg " << (double)totalCapacity / m << ", max " << maxCapacity << "\n";
+	std::cout << "w(j): sum " << totalWeight << ", avg " << (double)totalWeight / n << "\n";
+	std::cout << "s(k): sum " << totalSetup << ", avg " << (double)totalSetup / r << "\n";
+	std::cout << "b(k): avg " << (double)totalB / r << "\n";
+	std::cout << "tightness (sum c(i) / (sum w(j) + sum s(k))): " << (double)totalCapacity / (totalWeight + totalSetup) << "\n";
+	std::cout << "class sizes: min " << minSize << ", avg " << (double)n / r << ", max " << maxSize << "\n";
+	for (int h = 0; h < buckets; h++)
+		if (histogram[h] > 0)
+			std::cout << "\t[" << (1LL << h) << ", " << (1LL << (h + 1)) - 1 << "]\t" << histogram[h] << " classes\n";
+	std::cout << std::endl;
+}
+
 void printInstance(int n, int m, int r, int weights[], int capacities[], int profits[], int classes[], int indexes[], int setups[], int b[]) {
-	std::cout << "Instance value:" << std::endl;
 
-	std::cout << "j\t" << "i\t" << "p(i,j)\t" << "w(i)\t" << "class" << std::endl;
-	std::cout << "----------------------------------------" << std::endl;
+	// class of each item (findClass would scan all the items for each row)
+	int *itemClass = (int *)malloc(sizeof(int) * n);
+	computeItemClass(n, r, classes, indexes, itemClass);
+
+	// n*m rows: written through a buffer instead of flushing each line
+	std::cout.flush();
+	BufferedWriter out(stdout);
+
+	out.write("Instance value:\n");
+
+	out.write("j\ti\tp(i,j)\tw(i)\tclass\n");
+	out.write("----------------------------------------\n");
 	for (int i = 0; i < m; i++)
-		for (int j = 0; j < n; j++)
-			std::cout << j + 1 << "\t" << i + 1 << "\t" << profits[j + i * n] << "\t" << weights[j] << "\t" << findClass(j, classes, indexes, r) + 1 << std::endl;
-	std::cout << std::endl;
+		for (int j = 0; j < n; j++) {
+			out.write(j + 1); out.write('\t');
+			out.write(i + 1); out.write('\t');
+			out.write(profits[j + i * n]); out.write('\t');
+			out.write(weights[j]); out.write('\t');
+			out.write(itemClass[j] + 1); out.write('\n');
+		}
+	out.write('\n');
 
 	if (capacities != NULL) {
-		std::cout << "c(i)" << std::endl;
-		for (int i = 0; i < m; i++)
-			std::cout << capacities[i] << std::endl;
-		std::cout << std::endl;
+		out.write("c(i)\n");
+		for (int i = 0; i < m; i++) {
+			out.write(capacities[i]); out.write('\n');
+		}
+		out.write('\n');
 	}
 
 	if (setups != NULL) {
-		std::cout << "s(k)" << std::endl;
-		for (int i = 0; i < r; i++)
-			std::cout << setups[i] << std::endl;
-		std::cout << std::endl;
+		out.write("s(k)\n");
+		for (int i = 0; i < r; i++) {
+			out.write(setups[i]); out.write('\n');
+		}
+		out.write('\n');
 	}
 
 	if (b != NULL) {
-		std::cout << "b(k)" << std::endl;
-		for (int i = 0; i < r; i++)
-			std::cout << b[i] << std::endl;
-		std::cout << std::endl;
+		out.write("b(k)\n");
+		for (int i = 0; i < r; i++) {
+			out.write(b[i]); out.write('\n');
+		}
+		out.write('\n');
 	}
+
+	out.flush();
+	fflush(stdout);
+
+	free(itemClass);
 }
 
 void printInstance(int n, int m, int r, int weights[], int capacities[], int profits[], int itemKnapsack[], int itemIndex[], int classes[], int indexes[], int setups[], int b[]) {
@@ -1,16 +1,58 @@
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <string>
 #include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <climits>
 #include <vector>
 
 #include "UTILITY.h"
+#include "OUTPUT.h"
+#include "PROFITS.h"
 
 #ifndef RD_INSTANCE_H_
 #define RD_INSTANCE_H_
 
+/* binary format (native int32 values):
+ * magic "GMKPBIN1", n, m, r, w(j) [n], cap(i) [m], p(i, j) [n*m, knapsack after knapsack], t(r,j) [n, 0-based], s(r) [r], b(k) [r]
+ * */
+#define BINARY_INSTANCE_MAGIC "GMKPBIN1"
+
+/* read the instance in .inc format, or in binary format if the name ends with .bin
+ * 0, or a nonzero code with every array freed and set to NULL
+ * */
 int readInstance(char *file_name, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b);
 
+/* readInstance with the profits compressed a row at a time as they are read (see PROFITS.h): the n*m ints are
+ * never allocated
+ * */
+int readInstanceCompressed(char *file_name, int& n, int& m, int& r, int * &weights, int * &capacities, CompressedProfits &store, int * &classes, int * &indexes, int * &setups, int * &b);
+
+// read the instance from memory (e.g. received by the server): binary format if it starts with the magic, .inc format otherwise
+int readInstanceData(const char *data, size_t size, int& n, int& m, int& r, int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b);
+
+/* sizes whose model can be indexed by int: the columns n*m + m*r and the rows n*m + n + m + r
+ * (a size not read yet is passed as 0)
+ * */
+bool validInstanceSizes(int n, int m, int r);
+
+// frees the arrays of an instance not read completely (NULL ones are skipped) and sets them to NULL
+void freeInstanceArrays(int * &weights, int * &capacities, int * &profits, int * &classes, int * &indexes, int * &setups, int * &b);
+
+// classes and indexes from the class of each item (0-based), 1 if out of memory, 2 if a class is not valid, 4 if a class is empty
+int groupItemsByClass(int n, int r, const int *itemClass, int *classes, int *indexes);
+
+// verbosity of the instance printed by main
+#define PRINT_NONE 0
+#define PRINT_SUMMARY 1 // printInstanceSummary (default)
+#define PRINT_FULL 2 // printInstance
+
+// print n, m, r, statistics of capacities, weights, setups and b(k) and the histogram of the class sizes
+// the size of the output does not depend on the size of the instance
+void printInstanceSummary(int n, int m, int r, int weights[], int capacities[], int indexes[], int setups[], int b[]);
+
 // print instance if the order is known
 void printInstance(int n, int m, int r, int weights[], int capacities[], int profits[], int classes[], int indexes[], int setups[], int b[]);
 
@@ -0,0 +1,196 @@
+#include "JOURNAL.h"
+
+int openJournal(DiveJournal &journal, const char *file_name, CPXENVptr env, CPXLPptr lp) {
+
+	closeJournal(journal);
+	journal.ccnt = CPXgetnumcols(env, lp);
+	journal.lps = 0;
+
+	// base model: the SAV format keeps the order of the columns, so the indices of the journal are its indices
+	std::string model = std::string(file_name) + ".sav";
+	if (CPXwriteprob(env, lp, model.c_str(), "SAV")) {
+		std::cerr << "error: GMKP failed to write the base model of the journal" << std::endl;
+		return GMKP_ERROR_OPTIONS;
+	}
+
+	journal.lb.resize(journal.ccnt);
+	journal.ub.resize(journal.ccnt);
+	journal.currentLb.resize(journal.ccnt);
+	journal.currentUb.resize(journal.ccnt);
+	if (journal.ccnt > 0 && (CPXgetlb(env, lp, journal.lb.data(), 0, journal.ccnt - 1) || CPXgetub(env, lp, journal.ub.data(), 0, journal.ccnt - 1))) {
+		std::cerr << "error: GMKP failed to obtain CPX bounds" << std::endl;
+		return GMKP_ERROR_OPTIONS;
+	}
+
+	journal.file = fopen(file_name, "wb");
+	if (journal.file == NULL)
+		return GMKP_ERROR_OPTIONS;
+
+	int length = (int)model.size();
+	fwrite(JOURNAL_MAGIC, 1, 8, journal.file);
+	fwrite(&journal.ccnt, sizeof(int), 1, journal.file);
+	fwrite(&length, sizeof(int), 1, journal.file);
+	fwrite(model.c_str(), 1, length, journal.file);
+	fflush(journal.file);
+
+	return ferror(journal.file) ? GMKP_ERROR_OPTIONS : 0;
+}
+
+int appendJournal(DiveJournal &journal, CPXENVptr env, CPXLPptr lp, int solstat, double objval, double lpTime) {
+	if (journal.file == NULL)
+		return 0;
+
+	if (journal.ccnt > 0 && (CPXgetlb(env, lp, journal.currentLb.data(), 0, journal.ccnt - 1) || CPXgetub(env, lp, journal.currentUb.data(), 0, journal.ccnt - 1))) {
+		std::cerr << "error: GMKP failed to obtain CPX bounds" << std::endl;
+		return GMKP_ERROR_BOUNDS;
+	}
+
+	std::vector<int> changed;
+	for (int c = 0; c < journal.ccnt; c++)
+		if (journal.currentLb[c] != journal.lb[c] || journal.currentUb[c] != journal.ub[c])
+			changed.push_back(c);
+
+	int number = ++journal.lps;
+	int iterations = CPXgetitcnt(env, lp);
+	int changes = (int)changed.size();
+	fwrite(&number, sizeof(int), 1, journal.file);
+	fwrite(&solstat, sizeof(int), 1, journal.file);
+	fwrite(&objval, sizeof(double), 1, journal.file);
+	fwrite(&iterations, sizeof(int), 1, journal.file);
+	fwrite(&lpTime, sizeof(double), 1, journal.file);
+	fwrite(&changes, sizeof(int), 1, journal.file);
+	for (int t = 0; t < changes; t++) {
+		int c = changed[t];
+		fwrite(&c, sizeof(int), 1, journal.file);
+		fwrite(&journal.currentLb[c], sizeof(double), 1, journal.file);
+		fwrite(&journal.currentUb[c], sizeof(double), 1, journal.file);
+		journal.lb[c] = journal.currentLb[c];
+		journal.ub[c] = journal.currentUb[c];
+	}
+
+	// the journal is complete up to the last LP even if the run stops
+	fflush(journal.file);
+	return 0;
+}
+
+void closeJournal(DiveJournal &journal) {
+	if (journal.file != NULL)
+		fclose(journal.file);
+	journal.file = NULL;
+}
+
+int replayJournal(const char *file_name, int lp, const char *model_name) {
+
+	FILE *file = fopen(file_name, "rb");
+	if (file == NULL) {
+		std::cout << "Journal not read: " << file_name << std::endl;
+		return GMKP_ERROR_OPTIONS;
+	}
+
+	char magic[8];
+	int ccnt = 0, length = 0;
+	if (fread(magic, 1, 8, file) != 8 || memcmp(magic, JOURNAL_MAGIC, 8) != 0 || fread(&ccnt, sizeof(int), 1, file) != 1 || fread(&length, sizeof(int), 1, file) != 1 || length <= 0) {
+		std::cout << "Journal not valid: " << file_name << std::endl;
+		fclose(file);
+		return GMKP_ERROR_OPTIONS;
+	}
+	std::string model(length, '\0');
+	if (fread(&model[0], 1, length, file) != (size_t)length) {
+		std::cout << "Journal not valid: " << file_name << std::endl;
+		fclose(file);
+		return GMKP_ERROR_OPTIONS;
+	}
+
+	int status = 0;
+	CPXENVptr env = CPXopenCPLEX(&status);
+	if (status) {
+		std::cerr << "error: GMKP CPXopenCPLEX failed" << std::endl;
+		fclose(file);
+		return GMKP_ERROR_ENVIRONMENT;
+	}
+	CPXLPptr cpxlp = CPXcreateprob(env, &status, "GMKP - journal");
+	if (!status)
+		status = CPXreadcopyprob(env, cpxlp, model.c_str(), NULL);
+	if (!status && CPXgetnumcols(env, cpxlp) != ccnt)
+		status = 1;
+	if (status) {
+		std::cout << "Base model not read: " << model << std::endl;
+		status = GMKP_ERROR_MODEL;
+	}
+
+	// the changes of each LP up to the one asked
+	int last = 0;
+	double lastObjval = 0;
+	int lastSolstat = 0;
+	std::vector<int> indices;
+	std::vector<char> lu;
+	std::vector<double> bd;
+	while (!status && (lp <= 0 || last < lp)) {
+		int number, solstat, iterations, changes;
+		double objval, time;
+		if (fread(&number, sizeof(int), 1, file) != 1)
+			break;
+		if (fread(&solstat, sizeof(int), 1, file) != 1 || fread(&objval, sizeof(double), 1, file) != 1 || fread(&iterations, sizeof(int), 1, file) != 1 || fread(&time, sizeof(double), 1, file) != 1 || fread(&changes, sizeof(int), 1, file) != 1 || changes < 0) {
+			std::cout << "Journal truncated after the LP " << last << std::endl;
+			break;
+		}
+
+		indices.clear();
+		lu.clear();
+		bd.clear();
+		bool complete = true;
+		for (int t = 0; t < changes && complete; t++) {
+			int c;
+			double lower, upper;
+			complete = fread(&c, sizeof(int), 1, file) == 1 && fread(&lower, sizeof(double), 1, file) == 1 && fread(&upper, sizeof(double), 1, file) == 1 && c >= 0 && c < ccnt;
+			indices.push_back(c);
+			lu.push_back('L');
+			bd.push_back(lower);
+			indices.push_back(c);
+			lu.push_back('U');
+			bd.push_back(upper);
+		}
+		if (!complete) {
+			std::cout << "Journal truncated after the LP " << last << std::endl;
+			break;
+		}
+		if (!indices.empty() && CPXchgbds(env, cpxlp, (int)indices.size(), indices.data(), lu.data(), bd.data())) {
+			std::cerr << "error: GMKP failed to change CPX bounds" << std::endl;
+			status = GMKP_ERROR_BOUNDS;
+			break;
+		}
+
+		std::cout << "LP " << number << ": " << changes << " bounds changed, status " << solstat << ", objective " << objval << ", " << iterations << " simplex iterations, time " << time << std::endl;
+		last = number;
+		lastObjval = objval;
+		lastSolstat = solstat;
+	}
+	fclose(file);
+
+	if (!status && lp > 0 && last < lp)
+		std::cout << "The journal ends at the LP " << last << std::endl;
+
+	if (!status && model_name != NULL && CPXwriteprob(env, cpxlp, model_name, NULL)) {
+		std::cout << "Model not written: " << model_name << std::endl;
+		status = GMKP_ERROR_MODEL;
+	}
+
+	// the rebuilt lp solved again: the same status and objective of the dive
+	if (!status && last > 0) {
+		double objval = 0;
+		if (CPXlpopt(env, cpxlp)) {
+			std::cerr << "error: GMKP failed to optimize" << std::endl;
+			status = GMKP_ERROR_OPTIMIZE;
+		}
+		else {
+			int solstat = CPXgetstat(env, cpxlp);
+			if (CPXgetobjval(env, cpxlp, &objval))
+				objval = 0;
+			std::cout << "Replayed LP " << last << ": status " << solstat << ", objective " << objval << " (journal: status " << lastSolstat << ", objective " << lastObjval << ")" << std::endl;
+		}
+	}
+
+	CPXfreeprob(env, &cpxlp);
+	CPXcloseCPLEX(&env);
+	return status;
+}
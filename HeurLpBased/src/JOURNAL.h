@@ -0,0 +1,49 @@
+#include <ilcplex/cplex.h>
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+
+#include "GMKP.h"
+
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+
+#define JOURNAL_MAGIC "GMKPJRN1"
+
+/* journal of a dive: the lp is written once (file.sav) when the journal is opened, then each LP of the dive appends
+ * the bounds changed since the previous LP and its result; the lp of any LP is rebuilt by replayJournal
+ *
+ * file: magic (8 bytes), columns (int), length of the name of the base model (int), name
+ * each LP: lp (int), solstat (int), objval (double), simplex iterations (int), time (double), changes (int),
+ *          then index (int), lb (double), ub (double) of each bound changed
+ * */
+struct DiveJournal {
+	DiveJournal() : file(NULL), ccnt(0), lps(0) {}
+	~DiveJournal() { if (file != NULL) fclose(file); }
+
+	FILE *file; // NULL: not open
+	int ccnt; // columns of the lp
+	int lps; // LPs written
+	std::vector<double> lb; // bounds of the last LP written
+	std::vector<double> ub;
+	std::vector<double> currentLb;
+	std::vector<double> currentUb;
+};
+
+// the base model is written to file_name.sav; returns 0 or GMKP_ERROR_OPTIONS (journal not opened)
+int openJournal(DiveJournal &journal, const char *file_name, CPXENVptr env, CPXLPptr lp);
+
+// the bounds changed since the previous LP and the result of the LP just solved (objval ignored if infeasible)
+int appendJournal(DiveJournal &journal, CPXENVptr env, CPXLPptr lp, int solstat, double objval, double lpTime);
+
+void closeJournal(DiveJournal &journal);
+
+/* the lp of the LP number lp of the journal (0: the last one) is rebuilt from the base model, written to model_name
+ * (NULL: not written) and solved again; one line is printed for each LP up to it
+ * */
+int replayJournal(const char *file_name, int lp, const char *model_name);
+
+#endif /* JOURNAL_H_ */
@@ -0,0 +1,93 @@
+#include "KERNELS.h"
+
+// M > 0: m known at compile time, M == 0: m of the instance
+
+template <int M>
+long long itemAssignmentsKernel(const double *x, int n, int m, long long begin, long long end) {
+	const int knapsacks = M > 0 ? M : m;
+	for (long long j = begin; j < end; j++) {
+		// the sum is truncated at each step as in checkSolution
+		int sum = 0;
+		for (int i = 0; i < knapsacks; i++)
+			sum += x[(long long)i * n + j];
+		if (sum > 1)
+			return j;
+	}
+	return -1;
+}
+
+template <int M>
+int classOpeningsKernel(const double *x, int n, int m, int r, const int *b) {
+	const int knapsacks = M > 0 ? M : m;
+	const double *y = x + (long long)n * knapsacks;
+	for (int k = 0; k < r; k++) {
+		int sum = 0;
+		for (int i = 0; i < knapsacks; i++)
+			sum += y[(long long)i * r + k];
+		if (sum > b[k])
+			return k;
+	}
+	return -1;
+}
+
+// p(i,j) of the index i*n + j of x: from the ints or from the compressed rows
+struct IntProfits {
+	const int *profits;
+	int operator()(int, int, long long index) const { return profits[index]; }
+};
+
+struct StoredProfits {
+	const CompressedProfits *store;
+	int operator()(int i, int j, long long) const { return profitAt(*store, i, j); }
+};
+
+template <int M, typename Profits>
+void bestKnapsacksLoop(const double *x, const double *ub, Profits profitOf, const int *itemClass, const char *fixedItem, int n, int m, int r, int *best) {
+	const int knapsacks = M > 0 ? M : m;
+	const double *y = x + (long long)n * knapsacks;
+	for (int j = 0; j < n; j++) {
+		int bestKnapsack = -1;
+		double bestX = 0;
+		int bestProfit = 0;
+		if (!fixedItem[j]) {
+			int k = itemClass[j];
+			for (int i = 0; i < knapsacks; i++) {
+				long long index = (long long)i * n + j;
+				if (ub[index] < 0.5 || y[(long long)i * r + k] < 0.5)
+					continue;
+				if (bestKnapsack < 0 || x[index] > bestX || (x[index] == bestX && profitOf(i, j, index) > bestProfit)) {
+					bestKnapsack = i;
+					bestX = x[index];
+					bestProfit = profitOf(i, j, index);
+				}
+			}
+		}
+		best[j] = bestKnapsack;
+	}
+}
+
+template <int M>
+void bestKnapsacksKernel(const double *x, const double *ub, const int *profits, const int *itemClass, const char *fixedItem, int n, int m, int r, int *best) {
+	bestKnapsacksLoop<M>(x, ub, IntProfits{profits}, itemClass, fixedItem, n, m, r, best);
+}
+
+template <int M>
+void bestKnapsacksCompressedKernel(const double *x, const double *ub, const CompressedProfits &store, const int *itemClass, const char *fixedItem, int n, int m, int r, int *best) {
+	bestKnapsacksLoop<M>(x, ub, StoredProfits{&store}, itemClass, fixedItem, n, m, r, best);
+}
+
+template <int M>
+constexpr Kernels makeKernels() {
+	return Kernels{M, itemAssignmentsKernel<M>, classOpeningsKernel<M>, bestKnapsacksKernel<M <= KERNELS_MAX_M_BEST ? M : 0>, bestKnapsacksCompressedKernel<M <= KERNELS_MAX_M_BEST ? M : 0>};
+}
+
+// constant initialization: the table is ready before any other static initializer
+constexpr Kernels KERNELS[KERNELS_MAX_M + 1] = {
+	makeKernels<0>(), makeKernels<1>(), makeKernels<2>(), makeKernels<3>(), makeKernels<4>(), makeKernels<5>(),
+	makeKernels<6>(), makeKernels<7>(), makeKernels<8>(), makeKernels<9>(), makeKernels<10>(), makeKernels<11>(),
+	makeKernels<12>(), makeKernels<13>(), makeKernels<14>(), makeKernels<15>(), makeKernels<16>(),
+};
+
+const Kernels &selectKernels(int m) {
+	return m >= 1 && m <= KERNELS_MAX_M ? KERNELS[m] : KERNELS[0];
+}
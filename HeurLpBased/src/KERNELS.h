@@ -0,0 +1,35 @@
+#include "PROFITS.h"
+
+#ifndef KERNELS_H_
+#define KERNELS_H_
+
+// knapsack counts with their own kernels (the others use the generic one)
+#define KERNELS_MAX_M 16
+// bestKnapsacks only up to this m: the unrolled loop with its branches is slower than the generic one beyond it
+#define KERNELS_MAX_M_BEST 8
+
+/* loops over the m knapsacks of an item or of a class: instantiated with m known at compile time for m = 1..KERNELS_MAX_M,
+ * so the loop on the knapsacks is unrolled and the state of the item stays in registers; each kernel gives the same result
+ * of the loop it replaces for any m
+ * */
+struct Kernels {
+	int m; // knapsacks of the kernels (0: generic)
+
+	// constraint (2) on the items [begin, end): first item assigned more than once (-1: none)
+	long long (*itemAssignments)(const double *x, int n, int m, long long begin, long long end);
+
+	// constraint (3): first class open in more than b(k) knapsacks (-1: none)
+	int (*classOpenings)(const double *x, int n, int m, int r, const int *b);
+
+	/* knapsack of each free item (not fixedItem) among those with ub > 0.5 and its class open: the largest x,
+	 * then the largest profit, then the first knapsack (-1: none)
+	 * */
+	void (*bestKnapsacks)(const double *x, const double *ub, const int *profits, const int *itemClass, const char *fixedItem, int n, int m, int r, int *best);
+	// the same choice with the compressed profits
+	void (*bestKnapsacksCompressed)(const double *x, const double *ub, const CompressedProfits &store, const int *itemClass, const char *fixedItem, int n, int m, int r, int *best);
+};
+
+// kernels of an instance with m knapsacks, chosen once by the caller
+const Kernels &selectKernels(int m);
+
+#endif /* KERNELS_H_ */
@@ -0,0 +1,214 @@
+#include "KNAPSACK.h"
+
+void knapsackDP(ResidualKnapsack &problem);
+bool knapsackBB(ResidualKnapsack &problem);
+
+bool solveKnapsack(ResidualKnapsack &problem) {
+
+	int count = (int)problem.items.size();
+	problem.chosen.assign(count, 0);
+	problem.value = 0;
+	problem.exact = true;
+
+	if (count == 0 || problem.capacity <= 0)
+		return true;
+
+	if ((long long)(count + 1) * (problem.capacity + 1) <= KNAPSACK_DP_MAX_CELLS)
+		knapsackDP(problem);
+	else
+		problem.exact = knapsackBB(problem);
+
+	return problem.exact;
+}
+
+void solveKnapsacks(std::vector<ResidualKnapsack> &problems, int threads) {
+
+	int count = (int)problems.size();
+	if (threads > count)
+		threads = count;
+
+	if (threads <= 1) {
+		for (int t = 0; t < count; t++)
+			solveKnapsack(problems[t]);
+		return;
+	}
+
+	std::atomic<int> next(0);
+	std::vector<std::thread> workers;
+	for (int w = 0; w < threads; w++) {
+		workers.push_back(std::thread([&]() {
+			int t;
+			while ((t = next++) < count)
+				solveKnapsack(problems[t]);
+		}));
+	}
+	for (size_t w = 0; w < workers.size(); w++)
+		workers[w].join();
+}
+
+/* dp[c] = best profit with capacity c using the first t items
+ * each row is computed from the previous one without branches (vectorized by the compiler),
+ * only one bit for each cell is kept to rebuild the solution
+ * */
+void knapsackDP(ResidualKnapsack &problem) {
+
+	int count = (int)problem.items.size();
+	int capacity = (int)problem.capacity;
+	int words = capacity / 64 + 1;
+
+	std::vector<long long> prev(capacity + 1, 0);
+	std::vector<long long> cur(capacity + 1, 0);
+	std::vector<char> take(capacity + 1, 0);
+	std::vector<uint64_t> keep((size_t)count * words, 0);
+
+	for (int t = 0; t < count; t++) {
+		int w = problem.weights[t];
+		long long p = problem.profits[t];
+
+		if (w > capacity || p <= 0)
+			continue;
+
+		long long *pr = prev.data();
+		long long *cr = cur.data();
+		char *tk = take.data();
+
+		for (int c = 0; c < w; c++) {
+			cr[c] = pr[c];
+			tk[c] = 0;
+		}
+		for (int c = w; c <= capacity; c++) {
+			long long candidate = pr[c - w] + p;
+			tk[c] = candidate > pr[c];
+			cr[c] = candidate > pr[c] ? candidate : pr[c];
+		}
+
+		uint64_t *row = keep.data() + (size_t)t * words;
+		for (int c = w; c <= capacity; c++)
+			if (tk[c])
+				row[c >> 6] |= 1ULL << (c & 63);
+
+		prev.swap(cur);
+	}
+
+	problem.value = prev[capacity];
+
+	// rebuild the solution from the last item
+	int c = capacity;
+	for (int t = count - 1; t >= 0; t--) {
+		uint64_t *row = keep.data() + (size_t)t * words;
+		if ((row[c >> 6] >> (c & 63)) & 1) {
+			problem.chosen[t] = 1;
+			c -= problem.weights[t];
+		}
+	}
+}
+
+/* depth first branch and bound on the items sorted by profit/weight,
+ * with the bound of the continuous relaxation (Dantzig)
+ * */
+bool knapsackBB(ResidualKnapsack &problem) {
+
+	int count = (int)problem.items.size();
+	long long capacity = problem.capacity;
+
+	std::vector<int> order;
+	for (int t = 0; t < count; t++)
+		if (problem.weights[t] <= capacity && problem.profits[t] > 0)
+			order.push_back(t);
+
+	std::sort(order.begin(), order.end(), [&](int a, int b) {
+		return (long long)problem.profits[a] * problem.weights[b] > (long long)problem.profits[b] * problem.weights[a];
+	});
+
+	int size = (int)order.size();
+	std::vector<long long> p(size), w(size);
+	for (int t = 0; t < size; t++) {
+		p[t] = problem.profits[order[t]];
+		w[t] = problem.weights[order[t]];
+	}
+
+	std::vector<char> current(size, 0);
+	std::vector<char> best(size, 0);
+	long long bestValue = 0;
+
+	// greedy solution as first incumbent
+	long long residual = capacity;
+	for (int t = 0; t < size; t++)
+		if (w[t] <= residual) {
+			residual -= w[t];
+			bestValue += p[t];
+			best[t] = 1;
+		}
+
+	long long nodes = 0;
+	long long value = 0;
+	residual = capacity;
+	int t = 0;
+	bool exact = true;
+
+	while (true) {
+
+		// bound of the continuous relaxation from the item t
+		double bound = (double)value;
+		long long r = residual;
+		int s = t;
+		while (s < size && w[s] <= r) {
+			r -= w[s];
+			bound += p[s];
+			s++;
+		}
+		if (s < size)
+			bound += (double)p[s] * r / w[s];
+
+		if ((long long)bound > bestValue && ++nodes <= KNAPSACK_BB_MAX_NODES) {
+			// take the items from t to s - 1 (forward move)
+			for (int u = t; u < s; u++) {
+				current[u] = 1;
+				value += p[u];
+				residual -= w[u];
+			}
+			t = s;
+
+			if (t >= size) {
+				if (value > bestValue) {
+					bestValue = value;
+					best = current;
+				}
+			}
+			else {
+				// item s does not fit: skip it
+				current[t] = 0;
+				t++;
+				if (t < size)
+					continue;
+				if (value > bestValue) {
+					bestValue = value;
+					best = current;
+				}
+			}
+		}
+		else if (nodes > KNAPSACK_BB_MAX_NODES) {
+			exact = false;
+			break;
+		}
+
+		// backtrack: remove the last item taken and skip it
+		int u = t - 1;
+		while (u >= 0 && !current[u])
+			u--;
+		if (u < 0)
+			break;
+
+		current[u] = 0;
+		value -= p[u];
+		residual += w[u];
+		t = u + 1;
+	}
+
+	problem.value = bestValue;
+	for (int u = 0; u < size; u++)
+		if (best[u])
+			problem.chosen[order[u]] = 1;
+
+	return exact;
+}
@@ -0,0 +1,34 @@
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <algorithm>
+#include <cstdint>
+
+#ifndef KNAPSACK_H_
+#define KNAPSACK_H_
+
+// the dynamic programming is used if (items + 1) * (capacity + 1) is not greater than this value (bits of the choice table)
+#define KNAPSACK_DP_MAX_CELLS (1LL << 27)
+
+// nodes explored by the branch and bound before returning the best solution found
+#define KNAPSACK_BB_MAX_NODES 5000000
+
+// 0/1 knapsack left in a knapsack when the classes are fixed
+struct ResidualKnapsack {
+	std::vector<int> items; // items of the instance
+	std::vector<int> profits;
+	std::vector<int> weights;
+	long long capacity;
+	std::vector<char> chosen; // 1 if the item is in the solution
+	long long value; // profit of the solution
+	bool exact; // false if the branch and bound was stopped by the node limit
+};
+
+// solve a 0/1 knapsack: dynamic programming if the capacity is moderate, branch and bound otherwise
+// return false if the solution is not proven optimal
+bool solveKnapsack(ResidualKnapsack &problem);
+
+// solve the knapsacks in parallel (one knapsack at a time for each thread)
+void solveKnapsacks(std::vector<ResidualKnapsack> &problems, int threads);
+
+#endif /* KNAPSACK_H_ */
@@ -1,7 +1,12 @@
 #include "LPBASED_CPX.h"
+#include "MODEL.h"
 #include <numeric>
+#include <vector>
+#include <algorithm>
 
 
+int dive(CPXENVptr env, CPXLPptr lp, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, SolveParameters &params, Solution &solution, double *x, double *xRounded, Solution &current, double solveStart, ColumnSet *cols);
+
 void printStatusMsg(int statusCheck, int iteration) {
     if (statusCheck == 0)
         std::cout << "Iteration " << iteration << ": all constraints are ok" << std::endl;
@@ -17,13 +22,173 @@ void printStatusMsg(int statusCheck, int iteration) {
         std::cout << "Iteration " << iteration << ": optimal solution violated..." << std::endl;
 }
 
-void cplexComputeSolution(const cpxenv *env, cpxlp *lp, int &solstat, double *x, int &status, double &objval,
-                          double &objval_p) {
+// number of fractional values in x[begin ... end-1]
+int countFractional(double *x, int begin, int end) {
+	int count = 0;
+	for (int i = begin; i < end; i++)
+		if (double((int)x[i]) != x[i])
+			count++;
+	return count;
+}
+
+// variable the dive fixes next: the largest fractional y, or the largest fractional x when all y are integral (-1: none)
+int diveCandidate(double *x, int n, int m, int r) {
+	int candidate = -1;
+	for (int i = n*m; i < n*m + m*r; i++)
+		if (double((int)x[i]) != x[i] && (candidate < 0 || x[i] > x[candidate]))
+			candidate = i;
+	for (int i = 0; i < n*m && candidate < 0; i++)
+		if (double((int)x[i]) != x[i] && (candidate < 0 || x[i] > x[candidate]))
+			candidate = i;
+	return candidate;
+}
+
+/* LP values within the tolerance of 0 or 1 are set to it, so that the exact tests of the dive
+ * and of the checker see 0.9999999 as 1; a saved resolve is counted when the variable the dive
+ * would have fixed is one of them
+ * */
+void snapLpSolution(double *x, int n, int m, int r, double tolerance, DiveStatistics *stats) {
+	int candidate = stats != NULL ? diveCandidate(x, n, m, r) : -1;
+	int snapped = snapToIntegers(x, n*m + m*r, tolerance);
+	if (stats != NULL) {
+		stats->lps++;
+		stats->snappedValues += snapped;
+		if (candidate >= 0 && double((int)x[candidate]) == x[candidate])
+			stats->savedResolves++;
+	}
+}
+
+// round down the LP solution x, check it and add it to the pool
+void collectSolution(SolutionPool *pool, Solution &current, double *x, double *xRounded, double time, int n, int m, int r, int * b, int * weights, int * profits, const CompressedProfits *store, int * capacities, int * setups, int * classes, int * indexes) {
+	solutionFromX(current, x, profits, classes, indexes);
+	if (profits == NULL)
+		current.objval = assignedProfit(*store, current.itemKnapsack);
+	solutionToX(current, xRounded);
+	current.status = checkSolution(xRounded, current.objval, n, m, r, b, weights, profits, capacities, setups, classes, indexes);
+	current.time = time;
+	if (pool != NULL)
+		addToPool(*pool, current);
+}
+
+/* when all y are fixed, the problem left is a 0/1 knapsack for each knapsack:
+ * each free item goes to the open knapsack with the largest x (then the largest profit),
+ * the knapsacks are solved exactly in parallel and all the free x are fixed to the result
+ * boundChanges is the number of bounds changed
+ * */
+int fixResidualKnapsacks(CPXENVptr env, CPXLPptr lp, double *x, int n, int m, int r, int * weights, int * profits, const CompressedProfits *store, int * capacities, int * setups, int * classes, int * indexes, ColumnSet *cols, int &boundChanges) {
+
+	int status;
+	double *lb = new double[n*m];
+	double *ub = new double[n*m];
+
+	status = getBounds(env, lp, cols, lb, ub, 0, n*m - 1);
+	if (status) {
+		std::cerr << "error: GMKP failed to obtain CPX bounds" << std::endl;
+		delete[] lb;
+		delete[] ub;
+		return GMKP_ERROR_BOUNDS;
+	}
+
+	int *itemClass = (int *)malloc(sizeof(int) * n);
+	computeItemClass(n, r, classes, indexes, itemClass);
+
+	std::vector<ResidualKnapsack> problems(m);
+	for (int i = 0; i < m; i++) {
+		long long capacity = capacities[i];
+		for (int k = 0; k < r; k++)
+			if (x[n*m + i*r + k] > 0.5)
+				capacity -= setups[k];
+		for (int j = 0; j < n; j++)
+			if (lb[i*n + j] > 0.5)
+				capacity -= weights[j];
+		problems[i].capacity = capacity > 0 ? capacity : 0;
+	}
+
+	// items already fixed to 1 in a knapsack
+	char *fixedItem = (char *)calloc(n, sizeof(char));
+	for (int i = 0; i < m; i++)
+		for (int j = 0; j < n; j++)
+			if (lb[i*n + j] > 0.5)
+				fixedItem[j] = 1;
+
+	// knapsack of each free item (-1 if its class is not open anywhere)
+	int *itemKnapsack = (int *)malloc(sizeof(int) * n);
+	if (profits != NULL)
+		selectKernels(m).bestKnapsacks(x, ub, profits, itemClass, fixedItem, n, m, r, itemKnapsack);
+	else
+		selectKernels(m).bestKnapsacksCompressed(x, ub, *store, itemClass, fixedItem, n, m, r, itemKnapsack);
+	for (int j = 0; j < n; j++) {
+		int best = itemKnapsack[j];
+		itemKnapsack[j] = -1;
+		if (best >= 0) {
+			problems[best].items.push_back(j);
+			problems[best].profits.push_back(profits != NULL ? profits[best*n + j] : profitAt(*store, best, j));
+			problems[best].weights.push_back(weights[j]);
+		}
+	}
+
+	solveKnapsacks(problems, (int)std::thread::hardware_concurrency());
+
+	for (int i = 0; i < m; i++)
+		for (size_t t = 0; t < problems[i].items.size(); t++)
+			if (problems[i].chosen[t])
+				itemKnapsack[problems[i].items[t]] = i;
+
+	// every free x of an open class is fixed: 1 if chosen, 0 otherwise
+	int cnt = 0;
+	int *indices = new int[n*m];
+	char *lu = new char[n*m];
+	double *bd = new double[n*m];
+	for (int j = 0; j < n; j++) {
+		if (fixedItem[j])
+			continue;
+		for (int i = 0; i < m; i++) {
+			if (ub[i*n + j] < 0.5 || x[n*m + i*r + itemClass[j]] < 0.5)
+				continue;
+			indices[cnt] = i*n + j;
+			lu[cnt] = 'B';
+			bd[cnt] = itemKnapsack[j] == i ? 1.0 : 0.0;
+			cnt++;
+		}
+	}
+
+	status = cnt > 0 ? changeBounds(env, lp, cols, cnt, indices, lu, bd) : 0;
+	boundChanges = cnt;
+
+	delete[] indices;
+	delete[] lu;
+	delete[] bd;
+	delete[] lb;
+	delete[] ub;
+	free(itemClass);
+	free(fixedItem);
+	free(itemKnapsack);
+
+	if (status) {
+		std::cerr << "error: GMKP failed to change CPX bounds" << std::endl;
+		return GMKP_ERROR_BOUNDS;
+	}
+	return 0;
+}
+
+bool lpInfeasible(int solstat) {
+	return solstat == CPX_STAT_INFEASIBLE || solstat == CPX_STAT_INForUNBD || solstat == CPX_STAT_UNBOUNDED;
+}
+
+int cplexComputeSolution(const cpxenv *env, cpxlp *lp, int &solstat, double *x, double &objval,
+                          double &objval_p, ColumnSet *cols) {
+    int status;
     /* solve with CPLEX "lpopt" */
     status = CPXlpopt(env, lp);
     if (status) {
-        std::cout << "error: GMKP failed to optimize...exiting" << std::endl;
-        exit(1);
+        std::cerr << "error: GMKP failed to optimize" << std::endl;
+        return GMKP_ERROR_OPTIMIZE;
+    }
+    // restricted master: the columns with positive reduced cost are added until the LP is optimal for the full model
+    if (cols != NULL) {
+        status = generateColumns((CPXENVptr)env, lp, *cols);
+        if (status)
+            return status;
     }
     /*******************************************/
     /*  access CPLEX results                   */
@@ -35,13 +200,17 @@ void cplexComputeSolution(const cpxenv *env, cpxlp *lp, int &solstat, double *x,
 
     solstat = CPXgetstat(env, lp);
 
+    // no solution to read: the caller undoes the fixings (see backjump)
+    if (lpInfeasible(solstat))
+        return 0;
+
     /* OBJECTIVE VALUE
 * access objective function value
 * */
     status = CPXgetobjval(env, lp, &objval);
     if (status) {
-        std::cout << "error: GMKP failed to obtain objective value...exiting" << std::endl;
-        exit(1);
+        std::cerr << "error: GMKP failed to obtain objective value" << std::endl;
+        return GMKP_ERROR_SOLUTION;
     }
 
     /* BEST BOUND
@@ -54,64 +223,193 @@ void cplexComputeSolution(const cpxenv *env, cpxlp *lp, int &solstat, double *x,
         status = CPXgetobjval(env, lp, &objval_p);
     }
     if (status) {
-        std::cout << "error: GMKP failed to obtain best known bound...exiting" << std::endl;
-        std::cout << "CPXgetbestobjval returned " << status << std::endl;
-        exit(1);
+        std::cerr << "error: GMKP failed to obtain best known bound" << std::endl;
+        std::cerr << "CPXgetbestobjval returned " << status << std::endl;
+        return GMKP_ERROR_SOLUTION;
     }
 
-    status = CPXsolution(env, lp, &solstat, &objval_p, x, NULL, NULL, NULL);
+    status = CPXsolution(env, lp, &solstat, &objval_p, cols != NULL ? NULL : x, NULL, NULL, NULL);
+    if (!status && cols != NULL)
+        status = getColumnValues((CPXENVptr)env, lp, *cols, x);
     if (status) {
-        std::cout << "error: GMKP failed to check contraints of solution...exiting" << std::endl;
-        exit(1);
+        std::cerr << "error: GMKP failed to check contraints of solution" << std::endl;
+        return GMKP_ERROR_SOLUTION;
     }
+    return 0;
 }
 
-int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, char * modelFilename, char * logFilename, int TL) {
-
-	/*******************************************/
-	/*     set CPLEX environment and lp        */
-	/*******************************************/
-	CPXENVptr env;
-	CPXLPptr lp;
-	int status;
-	double objval;
-	clock_t start, end;
-	double time;
-
-	/* open CPLEX environment
-	 * */
-	env = CPXopenCPLEX(&status);
+/* bounds changed by the dive, one level for each LP: a level holds the bounds before the changes
+ * and the decision of the iteration (the fractional variable fixed, index * 2 + value, -1: none)
+ * */
+struct DiveTrail {
+	int ccnt;
+	ColumnSet *cols; // restricted master (NULL: full model), the trail uses the indices of the full model
+	std::vector<double> lb; // current bounds
+	std::vector<double> ub;
+	std::vector<double> newLb; // buffers of recordLevel
+	std::vector<double> newUb;
+	std::vector<int> indices; // column of each change
+	std::vector<double> oldLb;
+	std::vector<double> oldUb;
+	std::vector<size_t> levels; // first change of each level
+	std::vector<int> decisions;
+	std::vector<char> noGoods; // bit v set: fixing the column to v made an LP infeasible
+	std::vector<int> conflict; // buffers of the conflict refiner
+	std::vector<int> conflictStat;
+	std::vector<char> inConflict;
+};
+
+int initTrail(CPXENVptr env, CPXLPptr lp, DiveTrail &trail, int ccnt, ColumnSet *cols) {
+	trail.ccnt = ccnt;
+	trail.cols = cols;
+	trail.lb.resize(ccnt);
+	trail.ub.resize(ccnt);
+	trail.newLb.resize(ccnt);
+	trail.newUb.resize(ccnt);
+	trail.noGoods.assign(ccnt, 0);
+	trail.conflict.resize(ccnt);
+	trail.conflictStat.resize(ccnt);
+	trail.inConflict.resize(ccnt);
+
+	int status = getBounds(env, lp, cols, trail.lb.data(), trail.ub.data(), 0, ccnt - 1);
 	if (status) {
-		std::cout << "error: GMKP CPXopenCPLEX failed...exiting" << std::endl;
-		exit(1);
+		std::cerr << "error: GMKP failed to obtain CPX bounds" << std::endl;
+		return GMKP_ERROR_BOUNDS;
 	}
+	return 0;
+}
 
-	/* set CPLEX data checking ON
-	 * */
-	status = CPXsetintparam(env, CPX_PARAM_DATACHECK, CPX_ON);
+// the bounds changed since the last level (by the dive or by the subsolver) become a new level
+int recordLevel(CPXENVptr env, CPXLPptr lp, DiveTrail &trail, int decision) {
+	int status = getBounds(env, lp, trail.cols, trail.newLb.data(), trail.newUb.data(), 0, trail.ccnt - 1);
 	if (status) {
-		std::cout << "error: GMKP set CPLEX data checking ON failed...exiting" << std::endl;
-		exit(1);
+		std::cerr << "error: GMKP failed to obtain CPX bounds" << std::endl;
+		return GMKP_ERROR_BOUNDS;
 	}
 
-#ifndef NDEBUG
-	/* set CPLEX output ON
-	 * */
-	status = CPXsetintparam(env, CPX_PARAM_SCRIND, CPX_ON);
-	if (status) {
-		std::cout << "error: GMKP set CPLEX output ON failed...exiting" << std::endl;
-		exit(1);
+	trail.levels.push_back(trail.indices.size());
+	trail.decisions.push_back(decision);
+	for (int j = 0; j < trail.ccnt; j++)
+		if (trail.newLb[j] != trail.lb[j] || trail.newUb[j] != trail.ub[j]) {
+			trail.indices.push_back(j);
+			trail.oldLb.push_back(trail.lb[j]);
+			trail.oldUb.push_back(trail.ub[j]);
+			trail.lb[j] = trail.newLb[j];
+			trail.ub[j] = trail.newUb[j];
+		}
+	return 0;
+}
+
+// columns in the conflict of the infeasible LP; without the conflict refiner, the decision of the last level
+void findConflict(CPXENVptr env, CPXLPptr lp, DiveTrail &trail) {
+	std::fill(trail.inConflict.begin(), trail.inConflict.end(), 0);
+
+	int confnumrows, confnumcols, confstat;
+	int status = CPXrefineconflict(env, lp, &confnumrows, &confnumcols);
+	if (!status && confnumcols <= trail.ccnt) {
+		int *rowind = new int[confnumrows + 1];
+		int *rowbdstat = new int[confnumrows + 1];
+		status = CPXgetconflict(env, lp, &confstat, rowind, rowbdstat, &confnumrows, trail.conflict.data(), trail.conflictStat.data(), &confnumcols);
+		delete[] rowind;
+		delete[] rowbdstat;
+		if (!status) {
+			for (int c = 0; c < confnumcols; c++)
+				if (trail.conflictStat[c] != CPX_CONFLICT_EXCLUDED)
+					trail.inConflict[trail.cols != NULL ? trail.cols->fullIndex[trail.conflict[c]] : trail.conflict[c]] = 1;
+			return;
+		}
 	}
-#endif
 
-	/* create CPLEX lp
-	 * */
-	lp = CPXcreateprob(env, &status, "GMKP - Callable Library");
+	// local analysis: the fixings of a level keep the previous LP solution feasible, but its decision
+	for (size_t l = trail.decisions.size(); l-- > 0;)
+		if (trail.decisions[l] >= 0) {
+			trail.inConflict[trail.decisions[l] / 2] = 1;
+			return;
+		}
+}
+
+/* the LP is infeasible: the levels are undone up to the last decision in the conflict whose opposite value
+ * is not a no-good, the decision is recorded as a no-good and the opposite value is fixed as a new level;
+ * returns the level undone, -1 if there is none (the fixings kept by the dive are infeasible)
+ * */
+int backjump(CPXENVptr env, CPXLPptr lp, DiveTrail &trail, DiveStatistics *stats, int &status) {
+	findConflict(env, lp, trail);
+
+	int level = -1;
+	for (size_t l = trail.decisions.size(); l-- > 0 && level < 0;) {
+		int d = trail.decisions[l];
+		if (d >= 0 && trail.inConflict[d / 2] && !(trail.noGoods[d / 2] & (1 << (1 - d % 2))))
+			level = (int)l;
+	}
+	// no decision in the conflict can be flipped: the last one that can
+	for (size_t l = trail.decisions.size(); l-- > 0 && level < 0;) {
+		int d = trail.decisions[l];
+		if (d >= 0 && !(trail.noGoods[d / 2] & (1 << (1 - d % 2))))
+			level = (int)l;
+	}
+	status = 0;
+	if (level < 0)
+		return -1;
+
+	// restore the bounds before the level
+	size_t first = trail.levels[level];
+	size_t count = trail.indices.size() - first;
+	int *indices = new int[2 * count + 2];
+	char *lu = new char[2 * count + 2];
+	double *bd = new double[2 * count + 2];
+	int cnt = 0;
+	for (size_t c = trail.indices.size(); c-- > first;) {
+		int j = trail.indices[c];
+		trail.lb[j] = trail.oldLb[c];
+		trail.ub[j] = trail.oldUb[c];
+	}
+	for (size_t c = first; c < trail.indices.size(); c++) {
+		int j = trail.indices[c];
+		indices[cnt] = j;
+		lu[cnt] = 'L';
+		bd[cnt++] = trail.lb[j];
+		indices[cnt] = j;
+		lu[cnt] = 'U';
+		bd[cnt++] = trail.ub[j];
+	}
+
+	// no-good and opposite value
+	int d = trail.decisions[level];
+	int j = d / 2;
+	int value = 1 - d % 2;
+	trail.noGoods[j] |= 1 << (d % 2);
+	indices[cnt] = j;
+	lu[cnt] = 'B';
+	bd[cnt++] = value;
+
+	status = changeBounds(env, lp, trail.cols, cnt, indices, lu, bd);
+	delete[] indices;
+	delete[] lu;
+	delete[] bd;
 	if (status) {
-		std::cout << "error: GMKP CPXcreateprob failed...exiting" << std::endl;
-		exit(1);
+		std::cerr << "error: GMKP failed to change CPX bounds" << std::endl;
+		status = GMKP_ERROR_BOUNDS;
+		return -1;
+	}
+
+	if (stats != NULL) {
+		stats->undoneFixings += (int)count;
+		stats->noGoods++;
 	}
 
+	trail.indices.resize(first);
+	trail.oldLb.resize(first);
+	trail.oldUb.resize(first);
+	trail.levels.resize(level);
+	trail.decisions.resize(level);
+	status = recordLevel(env, lp, trail, j * 2 + value);
+	return level;
+}
+
+int buildModel(CPXENVptr env, CPXLPptr lp, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, const ParallelPlan *plan, const CompressedProfits *store) {
+
+	int status = 0;
+
 	/*******************************************/
 	/*     add CPLEX columns                   */
 	/*******************************************/
@@ -132,85 +430,84 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 	 * */
 
 	double *obj, *lb, *ub;
-	char *ctype;
 	char **vnames = 0;
 	char **cnames = 0;
 	int ccnt = n*m + m*r; // number of columns
 
-	int col; //column counter
-
 	/* set objective function sense
 	 * */
-	CPXchgobjsen(env, lp, CPX_MAX);
+	status = CPXchgobjsen(env, lp, CPX_MAX);
 	if (status) {
-		std::cout << "error: GMKP CPXchgobjsen failed...exiting" << std::endl;
-		exit(1);
+		std::cerr << "error: GMKP CPXchgobjsen failed" << std::endl;
+		return GMKP_ERROR_MODEL;
 	}
 
-	// allocate memory for column description
-	obj = new double[ccnt];
-	lb =  new double[ccnt];
-	ub =  new double[ccnt];
-	ctype = new char[ccnt];
-
-#ifndef NDEBUG
-	vnames = new char*[ccnt];
-	for (int i = 0; i < ccnt; i++)
-		vnames[i] = new char[100];
-#endif
-
-	col = 0; // init column counter
-
-	// fill column vectors
-	for (int i = 0; i < m; i++) {
-		for (int j = 0; j < n; j++) {
-
-			obj[col] = profits[i*n + j];
-			lb[col] = 0.0;
-			ub[col] = 1.0;
+	/* columns added in blocks of BUILD_COLUMN_BLOCK: the objective of the x is copied (or decoded) one block at a time,
+	 * not as a double copy of all the n*m profits
+	 * */
+	int block = (int)std::min((long long)ccnt, (long long)BUILD_COLUMN_BLOCK);
+	obj = new double[block];
+	lb =  new double[block];
+	ub =  new double[block];
+	for (int c = 0; c < block; c++) {
+		lb[c] = 0.0;
+		ub[c] = 1.0;
+	}
 
 #ifndef NDEBUG
-			sprintf(vnames[col], "x_%d_%d", i + 1, j + 1);
+	vnames = new char*[block];
+	for (int c = 0; c < block; c++)
+		vnames[c] = new char[100];
 #endif
-			col++;
-
-		} // j (items)
-	} // i (knapsacks)
-
-	for (int i = 0; i < m; i++) {
-		for (int k = 0; k < r; k++) {
 
-			obj[col] = 0;
-			lb[col] = 0.0;
-			ub[col] = 1.0;
+	for (int begin = 0; begin < ccnt && !status; begin += block) {
+		int count = std::min(block, ccnt - begin);
+
+		// x: a block may span several knapsacks
+		for (int c = begin; c < begin + count && c < n*m;) {
+			int i = c / n;
+			int j = c - i * n;
+			int last = std::min(n, j + (begin + count - c));
+			if (store != NULL)
+				decodeProfits(*store, i, j, last, obj + (c - begin));
+			else
+				for (int t = j; t < last; t++)
+					obj[c - begin + t - j] = profits[i*n + t];
+			c += last - j;
+		}
+		// y
+		for (int c = std::max(begin, n*m); c < begin + count; c++)
+			obj[c - begin] = 0;
 
 #ifndef NDEBUG
-			sprintf(vnames[col], "y_%d_%d", i + 1, k + 1);
+		for (int c = begin; c < begin + count; c++) {
+			if (c < n*m)
+				sprintf(vnames[c - begin], "x_%d_%d", c / n + 1, c % n + 1);
+			else
+				sprintf(vnames[c - begin], "y_%d_%d", (c - n*m) / r + 1, (c - n*m) % r + 1);
+		}
 #endif
-			col++;
-		} // k (classes)
-	} // i (knapsacks)
 
-	/* add columns to CPLEX LP
-	 * */
-	status = CPXnewcols(env, lp, ccnt, obj, lb, ub, NULL, vnames);
-	
-	if (status) {
-		std::cout << "error: GMKP CPXnewcols failed...exiting" << std::endl;
-		exit(1);
+		/* add columns to CPLEX LP
+		 * */
+		status = CPXnewcols(env, lp, count, obj, lb, ub, NULL, vnames);
 	}
 
 	// free columns stuff
 	delete [] lb;
 	delete [] ub;
 	delete [] obj;
-	delete [] ctype;
 #ifndef NDEBUG
-	for (int i = 0; i < ccnt; i++)
-		delete[] vnames[i];
-	delete vnames;
+	for (int c = 0; c < block; c++)
+		delete[] vnames[c];
+	delete[] vnames;
 #endif
 
+	if (status) {
+		std::cerr << "error: GMKP CPXnewcols failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+
 	/*******************************************/
 	/*   add CPLEX constraints                 */
 	/*******************************************/
@@ -234,28 +531,18 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 		cnames[i] = new char[100];
 #endif
 
-	// init counter
-	int cc = 0;
+	// the row i has n + r coefficients starting at i * (n + r)
 	for (int i = 0; i < m; i++)
 	{
-		rmatbeg[i] = cc; // starting index of the n-th constraint
+		rmatbeg[i] = i * (n + r); // starting index of the n-th constraint
 		sense[i] = 'L';
 		rhs[i] = capacities[i];
 
-		// \sum_{j = 1 ... n} w_j * x_ij
-		for (int j = 0; j < n; j++)
-		{
-			rmatind[cc] = i * n + j; // variable number
-			rmatval[cc] = weights[j];
-			cc++;
-		}
-
 		// \sum_{k = 1 ... r} s_k * y_ik
 		for (int k = 0; k < r; k++)
 		{
-			rmatind[cc] = n*m + i * r + k;
-			rmatval[cc] = setups[k];
-			cc++;
+			rmatind[rmatbeg[i] + n + k] = n*m + i * r + k;
+			rmatval[rmatbeg[i] + n + k] = setups[k];
 		}
 
 #ifndef NDEBUG
@@ -263,13 +550,19 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 #endif
 	}
 
+	// \sum_{j = 1 ... n} w_j * x_ij, in blocks of knapsacks
+	parallelBlocks(plan, (long long)n * m, 1, [&](int, long long begin, long long end) {
+		for (long long c = begin; c < end; c++) {
+			long long i = c / n;
+			long long j = c - i * n;
+			rmatind[i * (n + r) + j] = (int)c; // variable number
+			rmatval[i * (n + r) + j] = weights[j];
+		}
+	});
+
 	/* add rows for capacity constraints
 	 * */
 	status = CPXaddrows(env, lp, 0, rcnt, nzcnt, rhs, sense, rmatbeg, rmatind, rmatval, NULL, cnames);
-	if (status) {
-		std::cout << "error: GMKP CPXaddrows (1-th constraint) failed...exiting" << std::endl;
-		exit(1);
-	}
 
 	// free rows stuff
 	delete[] rmatbeg;
@@ -283,6 +576,11 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 	delete cnames;
 #endif
 
+	if (status) {
+		std::cerr << "error: GMKP CPXaddrows (1-th constraint) failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+
 	/*	constraint (2):
 		\sum_{i = 1 ... m} x_ij <= 1       \forall j \in N
 	 * */
@@ -303,34 +601,30 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 		cnames[i] = new char[100];
 #endif
 
-	// init counter
-	cc = 0;
-	// fill in rows for multiple knapsack constraints
-	for (int j = 0; j < rcnt; j++)
-	{
-		rmatbeg[j] = cc; // starting index of the n-th constraint
-		sense[j] = 'L';
-		rhs[j] = 1.0;
-
-		for (int i = 0; i < m; i++)
+	// fill in rows for multiple knapsack constraints, in blocks of items (the row j has m coefficients)
+	parallelBlocks(plan, n, m, [&](int, long long begin, long long end) {
+		for (long long j = begin; j < end; j++)
 		{
-			rmatind[cc] = i * n + j; // variable number
-			rmatval[cc] = 1.0;
-			cc++;
+			rmatbeg[j] = (int)(j * m); // starting index of the n-th constraint
+			sense[j] = 'L';
+			rhs[j] = 1.0;
+
+			for (int i = 0; i < m; i++)
+			{
+				rmatind[j * m + i] = (int)(i * n + j); // variable number
+				rmatval[j * m + i] = 1.0;
+			}
 		}
+	});
 
 #ifndef NDEBUG
+	for (int j = 0; j < rcnt; j++)
 		sprintf(cnames[j], "max_one_bin_x_%d", j + 1);
 #endif
-	}
 
 	/* add rows for multiple knapsack constraints
 	 * */
 	status = CPXaddrows(env, lp, 0, rcnt, nzcnt, rhs, sense, rmatbeg, rmatind, rmatval, NULL, cnames);
-	if (status) {
-		std::cout << "error: GMKP CPXaddrows (2-nd constraint) failed...exiting" << std::endl;
-		exit(1);
-	}
 
 	// free rows stuff
 	delete[] rmatbeg;
@@ -344,6 +638,11 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 	delete cnames;
 #endif
 
+	if (status) {
+		std::cerr << "error: GMKP CPXaddrows (2-nd constraint) failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+
 	/*	constraint (3):
 		\sum_{i = 1 ... m} y_ik <= b_k		\forall k \in K
 	 * */
@@ -365,7 +664,7 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 #endif
 
 	// init counter
-	cc = 0;
+	int cc = 0;
 	// fill in rows for multiple knapsack constraints
 	for (int k = 0; k < rcnt; k++)
 	{
@@ -388,10 +687,6 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 	/* add rows for multiple knapsack constraints
 	 * */
 	status = CPXaddrows(env, lp, 0, rcnt, nzcnt, rhs, sense, rmatbeg, rmatind, rmatval, NULL, cnames);
-	if (status) {
-		std::cout << "error: GMKP CPXaddrows (3-rd constraint) failed...exiting" << std::endl;
-		exit(1);
-	}
 
 	// free rows stuff
 	delete[] rmatbeg;
@@ -405,6 +700,11 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 	delete cnames;
 #endif
 
+	if (status) {
+		std::cerr << "error: GMKP CPXaddrows (3-rd constraint) failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+
 	/*	constraint (4):
 		x_ij <= y_ik		\forall i \in M, \forall k \in K, \forall j \in R_k
 		x_ij - y_ik <= 0	\forall i \in M, \forall k \in K, \forall j \in R_k
@@ -426,45 +726,39 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 		cnames[i] = new char[100];
 #endif
 
-	// init counter
-	cc = 0;
-	int prov2 = 0;
-	// fill in rows for multiple knapsack constraints
-	for (int k = 0; k < r; k++) {
-		int indexes_prev = k > 0 ? indexes[k - 1] : 0;
-		for (int z = 0; z < indexes[k] - indexes_prev; z++) {
+	/* fill in rows for multiple knapsack constraints: the item at the position z of classes (class k)
+	 * has the rows z * m + i, each with 2 coefficients; blocks of positions
+	 * */
+	parallelBlocks(plan, n, m, [&](int, long long begin, long long end) {
+		int k = (int)(std::upper_bound(indexes, indexes + r, (int)begin) - indexes);
+		for (long long z = begin; z < end; z++) {
+			while (z >= indexes[k])
+				k++;
 
 			for (int i = 0; i < m; i++) {
+				long long row = z * m + i;
 
-				rmatbeg[prov2] = cc; // starting index of the n-th constraint
-				sense[prov2] = 'L';
-				rhs[prov2] = 0.0;
+				rmatbeg[row] = (int)(2 * row); // starting index of the n-th constraint
+				sense[row] = 'L';
+				rhs[row] = 0.0;
 
-				rmatind[cc] = n * m + i * r + k; // variable number
-				rmatval[cc] = -1;
-				cc++;
+				rmatind[2 * row] = n * m + i * r + k; // variable number
+				rmatval[2 * row] = -1;
 
-				rmatind[cc] = n * i + classes[z + indexes_prev]; // variable number
-				rmatval[cc] = 1;
-				cc++;
+				rmatind[2 * row + 1] = n * i + classes[z]; // variable number
+				rmatval[2 * row + 1] = 1;
+			} // i (knapsacks)
+		} // z (items)
+	});
 
 #ifndef NDEBUG
-				sprintf(cnames[prov2], "dependent_decision_%d", prov2 + 1);
+	for (int row = 0; row < rcnt; row++)
+		sprintf(cnames[row], "dependent_decision_%d", row + 1);
 #endif
 
-				prov2++;
-			} // k (classes)
-		} // n (items)
-
-	} // i (knapsacks)
-
 	/* add rows for multiple knapsack constraints
 	 * */
 	status = CPXaddrows(env, lp, 0, rcnt, nzcnt, rhs, sense, rmatbeg, rmatind, rmatval, NULL, cnames);
-	if (status) {
-		std::cout << "error: GMKP CPXaddrows (4-th constraint) failed...exiting" << std::endl;
-		exit(1);
-	}
 
 	// free rows stuff
 	delete[] rmatbeg;
@@ -478,20 +772,174 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 	delete cnames;
 #endif
 
-#ifndef NDEBUG
-	status = CPXwriteprob(env, lp, modelFilename, NULL);
 	if (status) {
-		std::cout << "error: GMKP failed to write MODEL file" << std::endl;
+		std::cerr << "error: GMKP CPXaddrows (4-th constraint) failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+
+	return status;
+}
+
+void initSolveParameters(SolveParameters &params) {
+	params.modelFilename = NULL;
+	params.logFilename = NULL;
+	params.journalFilename = NULL;
+	params.TL = 0;
+	params.timeLimit = 0;
+	params.iterationLimit = 0;
+	params.report = NULL;
+	params.pool = NULL;
+	params.warmStart = NULL;
+	params.exactSubproblems = true;
+	params.env = NULL;
+	params.model = NULL;
+	params.verbose = true;
+	params.integralityTolerance = SOLUTION_EPS;
+	params.stats = NULL;
+	params.parallel = NULL;
+	params.columnGeneration = 0;
+	params.columnBatch = 0;
+	params.symmetry = true;
+	params.profitStore = NULL;
+	params.perf = NULL;
+}
+
+int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, SolveParameters &params, Solution &solution) {
+
+	/*******************************************/
+	/*     set CPLEX environment and lp        */
+	/*******************************************/
+	Model *model = params.model;
+	CPXENVptr env = model != NULL ? model->env : params.env;
+	CPXLPptr lp = model != NULL ? model->lp : NULL;
+	int status = 0;
+	double solveStart = wallClock();
+
+	/* open CPLEX environment (unless the caller keeps one open)
+	 * */
+	if (env == NULL) {
+		env = CPXopenCPLEX(&status);
+		if (status) {
+			std::cerr << "error: GMKP CPXopenCPLEX failed" << std::endl;
+			return GMKP_ERROR_ENVIRONMENT;
+		}
+	}
+
+	/* set CPLEX data checking ON
+	 * */
+	status = CPXsetintparam(env, CPX_PARAM_DATACHECK, CPX_ON);
+	if (status) {
+		std::cerr << "error: GMKP set CPLEX data checking ON failed" << std::endl;
+		status = GMKP_ERROR_PARAMETERS;
+	}
+
+#ifndef NDEBUG
+	/* set CPLEX output ON
+	 * */
+	if (!status && CPXsetintparam(env, CPX_PARAM_SCRIND, CPX_ON)) {
+		std::cerr << "error: GMKP set CPLEX output ON failed" << std::endl;
+		status = GMKP_ERROR_PARAMETERS;
 	}
 #endif
 
+	/* the compressed profits are read only by the model build and the full dive
+	 * */
+	if (!status && params.profitStore != NULL && (model != NULL || params.columnGeneration > 0 || params.warmStart != NULL)) {
+		std::cerr << "error: GMKP compressed profits not used with a kept model, column generation or a warm start" << std::endl;
+		status = GMKP_ERROR_PARAMETERS;
+	}
+
+	/* create CPLEX lp (unless the model is kept by the caller)
+	 * */
+	ColumnSet columnSet;
+	ColumnSet *cols = NULL;
+	if (!status && model == NULL) {
+		lp = CPXcreateprob(env, &status, "GMKP - Callable Library");
+		if (status) {
+			std::cerr << "error: GMKP CPXcreateprob failed" << std::endl;
+			status = GMKP_ERROR_ENVIRONMENT;
+		}
+		else if (params.columnGeneration > 0) {
+			// restricted master: the x are added by pricing (see COLUMNS.h)
+			cols = &columnSet;
+			startPhase(params.perf, PERF_PHASE_BUILD);
+			status = buildRestrictedModel(env, lp, n, m, r, b, weights, profits, capacities, setups, classes, indexes, params.columnGeneration, params.columnBatch, columnSet);
+			stopPhase(params.perf);
+		}
+		else {
+			startPhase(params.perf, PERF_PHASE_BUILD);
+			status = buildModel(env, lp, n, m, r, b, weights, profits, capacities, setups, classes, indexes, params.parallel, params.profitStore);
+			stopPhase(params.perf);
+		}
+	}
+
+	/* identical knapsacks: orbit ordering on the y (the kept model is changed in place by the caller, so it keeps none)
+	 * */
+	if (!status && model == NULL && params.symmetry) {
+		KnapsackOrbits orbits;
+		findKnapsackOrbits(n, m, capacities, profits, params.profitStore, params.parallel, orbits);
+		int fixings = 0;
+		int rows = 0;
+		status = addOrbitOrdering(env, lp, cols, orbits, n, m, r, b, classes, indexes, fixings, rows);
+		if (!status && params.warmStart != NULL)
+			canonicalSolution(orbits, *params.warmStart);
+		if (params.verbose && orbits.count > 0)
+			std::cout << "Identical knapsacks: " << orbits.knapsacks << " in " << orbits.count << " orbits, " << fixings << " bounds and " << rows << " rows of orbit ordering" << std::endl;
+	}
+
+	int ccnt = n*m + m*r; // number of columns
+
 #ifndef NDEBUG
-	status = CPXsetlogfilename(env, logFilename, "w");
-	if (status) {
-		std::cout << "error: GMKP failed to write LOG file" << std::endl;
+	if (!status && params.modelFilename != NULL && CPXwriteprob(env, lp, params.modelFilename, NULL)) {
+		std::cerr << "error: GMKP failed to write MODEL file" << std::endl;
+	}
+#endif
+
+#ifndef NDEBUG
+	if (!status && params.logFilename != NULL && CPXsetlogfilename(env, params.logFilename, "w")) {
+		std::cerr << "error: GMKP failed to write LOG file" << std::endl;
 	}
 #endif
 
+	// LP solution and its rounding, rounded solutions of the dive
+	double *x = new double[ccnt];
+	double *xRounded = new double[ccnt];
+	Solution current;
+	initSolution(current, n, m, r);
+
+	if (!status)
+		status = dive(env, lp, n, m, r, b, weights, profits, capacities, setups, classes, indexes, params, solution, x, xRounded, current, solveStart, cols);
+
+	freeSolution(current);
+	delete[] x;
+	delete[] xRounded;
+
+	/* free CPLEX (the kept model and the environment of the caller stay open) */
+	if (model == NULL && lp != NULL)
+		CPXfreeprob(env, &lp);
+
+	if (model == NULL && params.env == NULL)
+		CPXcloseCPLEX(&env);
+
+	return status;
+}
+
+/* dive of solve() on the lp already built: every error is returned as a GMKP_ERROR code
+ * x, xRounded and current are buffers of the caller
+ * */
+int dive(CPXENVptr env, CPXLPptr lp, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, SolveParameters &params, Solution &solution, double *x, double *xRounded, Solution &current, double solveStart, ColumnSet *cols) {
+
+	Model *model = params.model;
+	RunReport *report = params.report;
+	SolutionPool *pool = params.pool;
+	Solution *warmStart = params.warmStart;
+	int TL = params.TL;
+	int ccnt = n*m + m*r; // number of columns
+	int status;
+	double objval;
+	clock_t start, end;
+	double time;
+
 	/*******************************************/
 	/*   solve program with CPLEX    */
 	/*******************************************/
@@ -500,38 +948,106 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 	 * */
 	status = CPXsetintparam(env, CPX_PARAM_THREADS, 1);
 	if (status) {
-		std::cout << "error: GMKP failed to set CPX threads parameter...exiting" << std::endl;
-		exit(1);
+		std::cerr << "error: GMKP failed to set CPX threads parameter" << std::endl;
+		return GMKP_ERROR_PARAMETERS;
 	}
 
 	status = CPXsetintparam(env, CPX_PARAM_SCRIND, 0);
 	if (status) {
-		std::cout << "error: GMKP failed to disable CPX output parameter...exiting" << std::endl;
-		exit(1);
+		std::cerr << "error: GMKP failed to disable CPX output parameter" << std::endl;
+		return GMKP_ERROR_PARAMETERS;
 	}
 
-	/* set CPLEX time limit (in seconds)
+	/* set CPLEX time limit (in seconds), reset when the environment is reused
 	 * */
-	if (TL > 0)
-		status = CPXsetdblparam(env, CPX_PARAM_TILIM, TL);
+	status = CPXsetdblparam(env, CPX_PARAM_TILIM, TL > 0 ? TL : 1e75);
 	if (status) {
-		std::cout << "error: GMKP failed to set CPX time limit parameter...exiting" << std::endl;
-		exit(1);
+		std::cerr << "error: GMKP failed to set CPX time limit parameter" << std::endl;
+		return GMKP_ERROR_PARAMETERS;
+	}
+
+	/* journal: the lp as built, then the bounds changed before each LP
+	 * */
+	DiveJournal journal;
+	if (params.journalFilename != NULL) {
+		if (cols != NULL)
+			std::cerr << "Journal not written with column generation: " << params.journalFilename << std::endl;
+		else if (openJournal(journal, params.journalFilename, env, lp))
+			std::cerr << "Journal not written: " << params.journalFilename << std::endl;
+	}
+
+	/* fix the items and the classes of the warm start
+	 * */
+	if (warmStart != NULL) {
+		int cnt = 0;
+		int *wsIndices = new int[ccnt];
+		for (int j = 0; j < n; j++)
+			if (warmStart->itemKnapsack[j] >= 0)
+				wsIndices[cnt++] = warmStart->itemKnapsack[j] * n + j;
+		for (int i = 0; i < m*r; i++)
+			if (warmStart->openClasses[i])
+				wsIndices[cnt++] = n*m + i;
+
+		char *wsLu = new char[cnt + 1];
+		double *wsBd = new double[cnt + 1];
+		for (int i = 0; i < cnt; i++) {
+			wsLu[i] = 'L';
+			wsBd[i] = 1.0;
+		}
+
+		status = cnt > 0 ? changeBounds(env, lp, cols, cnt, wsIndices, wsLu, wsBd) : 0;
+
+		delete[] wsIndices;
+		delete[] wsLu;
+		delete[] wsBd;
+
+		if (status) {
+			std::cerr << "error: GMKP failed to change CPX bounds" << std::endl;
+			return GMKP_ERROR_BOUNDS;
+		}
+
+		if (pool != NULL)
+			addToPool(*pool, *warmStart);
+	}
+
+	/* kept model: the first LP starts from the optimal basis of the first LP of the previous solve
+	 * */
+	if (model != NULL && model->hasBasis) {
+		status = CPXcopybase(env, lp, model->cstat, model->rstat);
+		if (status) {
+			std::cerr << "error: GMKP failed to copy the starting basis" << std::endl;
+			return GMKP_ERROR_OPTIMIZE;
+		}
 	}
 
 	/* solve with CPLEX "lpopt"
 	 * */
 	start = clock();
+	double lpStart = wallClock();
+	startPhase(params.perf, PERF_PHASE_LP);
 	status = CPXlpopt(env, lp);
+	if (!status && cols != NULL) {
+		status = generateColumns(env, lp, *cols);
+		if (status)
+			return status;
+	}
+	stopPhase(params.perf);
+	double lpTime = wallClock() - lpStart;
 	end = clock();
 	time = ((double)(end - start)) / CLOCKS_PER_SEC;
 
+	double lpTimeTotal = lpTime;
+	int simplexIterations = CPXgetitcnt(env, lp);
+
 
 	if (status) {
-		std::cout << "error: GMKP failed to optimize...exiting" << std::endl;
-		exit(1);
+		std::cerr << "error: GMKP failed to optimize" << std::endl;
+		return GMKP_ERROR_OPTIMIZE;
 	}
 
+	if (model != NULL)
+		model->hasBasis = CPXgetbase(env, lp, model->cstat, model->rstat) == 0;
+
 	/*******************************************/
 	/*  access CPLEX results                   */
 	/*******************************************/
@@ -542,25 +1058,36 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 	int solstat;
 
 	solstat = CPXgetstat(env, lp);
+	if (lpInfeasible(solstat)) {
+		std::cerr << "error: GMKP first LP infeasible" << std::endl;
+		return GMKP_ERROR_INFEASIBLE;
+	}
 
 	/* OBJECTIVE VALUE
 	 * access objective function value
 	 * */
 	status = CPXgetobjval(env, lp, &objval);
 	if (status) {
-		std::cout << "error: GMKP failed to obtain objective value...exiting" << std::endl;
-		exit(1);
+		std::cerr << "error: GMKP failed to obtain objective value" << std::endl;
+		return GMKP_ERROR_SOLUTION;
 	}
 
+	status = appendJournal(journal, env, lp, solstat, objval, lpTime);
+	if (status)
+		return status;
+
 	/* BEST BOUND
 	 * access the currently best known bound of all the remaining open nodes in a branch-and-bound tree
 	 * */
 	 double objval_p;
 
-	CPXgetbestobjval(env, lp, &objval_p);
+	status = CPXgetbestobjval(env, lp, &objval_p);
+	// an LP has no best bound: it is its objective (as in cplexComputeSolution)
+	if (status == CPXERR_NOT_MIP)
+		status = CPXgetobjval(env, lp, &objval_p);
 	if (status) {
-		std::cout << "error: GMKP failed to obtain best known bound...exiting" << std::endl;
-		exit(1);
+		std::cerr << "error: GMKP failed to obtain best known bound" << std::endl;
+		return GMKP_ERROR_SOLUTION;
 	}
 
 	/*
@@ -568,28 +1095,36 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 	* access the vector x to find solution
 	*/
 
-	double *x = new double[ccnt];
-
-	status = CPXsolution(env, lp, &solstat, &objval_p, x, NULL, NULL, NULL);
+	status = CPXsolution(env, lp, &solstat, &objval_p, cols != NULL ? NULL : x, NULL, NULL, NULL);
+	if (!status && cols != NULL)
+		status = getColumnValues(env, lp, *cols, x);
 	if (status) {
-		std::cout << "error: GMKP failed to check contraints of solution...exiting" << std::endl;
-		exit(1);
+		std::cerr << "error: GMKP failed to check contraints of solution" << std::endl;
+		return GMKP_ERROR_SOLUTION;
 	}
 
-	int statusCheck = checkSolution(x, objval, n, m, r, b, weights, profits, capacities, setups, classes, indexes);
+	if (params.stats != NULL) {
+		params.stats->lps = 0;
+		params.stats->snappedValues = 0;
+		params.stats->savedResolves = 0;
+		params.stats->conflicts = 0;
+		params.stats->undoneFixings = 0;
+		params.stats->noGoods = 0;
+		params.stats->columns = n*m;
+		params.stats->pricingRounds = 0;
+	}
+	snapLpSolution(x, n, m, r, params.integralityTolerance, params.stats);
+
+	startPhase(params.perf, PERF_PHASE_CHECK);
+	int statusCheck = checkSolutionParallel(params.parallel, x, objval, n, m, r, b, weights, profits, capacities, setups, classes, indexes);
+	stopPhase(params.perf);
 
-	if (statusCheck == 0)
-		std::cout << "Iteration 1: all constraints are ok" << std::endl;
-	else if (statusCheck == 1)
-		std::cout << "Iteration 1: constraint violated: weights of the items are greater than the capacity..." << std::endl;
-	else if (statusCheck == 2)
-		std::cout << "Iteration 1: constraint violated: item is assigned to more than one knapsack..." << std::endl;
-	else if (statusCheck == 3)
-		std::cout << "Iteration 1: constraint violated: class is assigned to more than one knapsack..." << std::endl;
-	else if (statusCheck == 4)
-		std::cout << "Iteration 1: constraint violated: items of class are not assigned to knapsack..." << std::endl;
-	else if (statusCheck == 5)
-		std::cout << "Iteration 1: optimal solution violeted..." << std::endl;
+	// rounded solutions of the dive
+	if (pool != NULL)
+		collectSolution(pool, current, x, xRounded, wallClock() - solveStart, n, m, r, b, weights, profits, params.profitStore, capacities, setups, classes, indexes);
+
+	if (params.verbose)
+		printStatusMsg(statusCheck, 1);
 
 	/*******************************************/
 	/*   change Upper/Lower bown with CPLEX    */
@@ -598,17 +1133,36 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 	bool allInt = true;
 	int indexBestValue = 0;
 	double bestValue = -1;
-	int *indices = new int[1];
-	double *bd = new double[1];
+	int indices[1];
+	double bd[1];
 	int iteration = 2;
 
-	int truncated = (int)objval;
+	// telemetry of the current LP solution
+	TraceIteration record;
+	int fractionalX = 0;
+	int fractionalY = 0;
+	int boundChanges = 0;
+
     bool flag = false;
-	while (objval != truncated) {
+	bool subsolved = false;
+
+	// fixings of the dive, undone when an LP is infeasible
+	DiveTrail trail;
+	status = initTrail(env, lp, trail, ccnt, cols);
+	if (status)
+		return status;
+	int decision;
+	int classesLevel = -1; // level where the classes are fixed
+	while (countFractional(x, 0, ccnt) > 0 && (params.timeLimit <= 0 || wallClock() - solveStart < params.timeLimit) && (params.iterationLimit <= 0 || iteration - 2 < params.iterationLimit)) {
 
 		allInt = true;
 		indexBestValue = 0;
 		bestValue = -1;
+		fractionalX = 0;
+		fractionalY = 0;
+		boundChanges = 0;
+		decision = -1;
+		startPhase(params.perf, PERF_PHASE_SCAN);
 
 		/*for (int i = 0; i < n*m + m * r; i++) {
 			std::cout << x[i] << std::endl;
@@ -625,15 +1179,17 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 			if (value == 1) {
 				bd[0] = 1;
 				indices[0] = m * n + i;
-				status = CPXchgbds(env, lp, 1, indices, "L", bd);
+				status = changeBounds(env, lp, cols, 1, indices, "L", bd);
 				if (status) {
-					std::cout << "error: GMKP failed to change CPX bounds...exiting" << std::endl;
-					exit(1);
+					std::cerr << "error: GMKP failed to change CPX bounds" << std::endl;
+					return GMKP_ERROR_BOUNDS;
 				}
+				boundChanges++;
 			}
 			// find best value
 			else if (double(truncatedValue) != value) {
 				allInt = false;
+				fractionalY++;
 				if (x[m * n + i] > bestValue) {
 					bestValue = x[m * n + i];
 					indexBestValue = m * n + i;
@@ -652,24 +1208,38 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
                     if (x[m * n + i] == 0) {
                         bd[0] = 0;
                         indices[0] = m * n + i;
-                        status = CPXchgbds(env, lp, 1, indices, "B", bd);
+                        status = changeBounds(env, lp, cols, 1, indices, "B", bd);
                         if (status) {
-                            std::cout << "error: GMKP failed to change CPX bounds...exiting" << std::endl;
-                            exit(1);
+                            std::cerr << "error: GMKP failed to change CPX bounds" << std::endl;
+                            return GMKP_ERROR_BOUNDS;
                         }
                     } else {
                         bd[0] = 1;
                         indices[0] = m * n + i;
-                        status = CPXchgbds(env, lp, 1, indices, "B", bd);
+                        status = changeBounds(env, lp, cols, 1, indices, "B", bd);
                         if (status) {
-                            std::cout << "error: GMKP failed to change CPX bounds...exiting" << std::endl;
-                            exit(1);
+                            std::cerr << "error: GMKP failed to change CPX bounds" << std::endl;
+                            return GMKP_ERROR_BOUNDS;
                         }
                     }
                 }
+                boundChanges += m * r;
                 flag = true;
+                classesLevel = (int)trail.levels.size();
+
+                // the classes are fixed: the tail of the dive is replaced by the exact subsolver (not part of the scan)
+                if (params.exactSubproblems) {
+                    int fixed = 0;
+                    stopPhase(params.perf);
+                    status = fixResidualKnapsacks(env, lp, x, n, m, r, weights, profits, params.profitStore, capacities, setups, classes, indexes, cols, fixed);
+                    startPhase(params.perf, PERF_PHASE_SCAN);
+                    if (status)
+                        return status;
+                    boundChanges += fixed;
+                    subsolved = true;
+                }
             }
-			for (int i = 0; i < n*m; i++) {
+			for (int i = 0; i < n*m && !subsolved; i++) {
 				double value = x[i];
                 //std::cout << "x[" << i << "] = " << value << std::endl;
 				int truncatedValue = (int)value;
@@ -678,15 +1248,17 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 				if (value == 1) {
 					bd[0] = 1;
 					indices[0] = i;
-					status = CPXchgbds(env, lp, 1, indices, "L", bd);
+					status = changeBounds(env, lp, cols, 1, indices, "L", bd);
 					if (status) {
-						std::cout << "error: GMKP failed to change CPX bounds...exiting" << std::endl;
-						exit(1);
+						std::cerr << "error: GMKP failed to change CPX bounds" << std::endl;
+						return GMKP_ERROR_BOUNDS;
 					}
+					boundChanges++;
 				}
 				// find best value
 				else if (double(truncatedValue) != value) {
 					allInt = false;
+					fractionalX++;
 					if (x[i] > bestValue) {
 						bestValue = x[i];
 						indexBestValue = i;
@@ -697,6 +1269,11 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
 			} // for x*
 
 		}
+		else if (report != NULL) {
+			// x* is not scanned while there are fractional y*: count only for the trace
+			fractionalX = countFractional(x, 0, n*m);
+		}
+		stopPhase(params.perf);
 
 		// there is a fractional value
 		if (!allInt) {
@@ -710,68 +1287,159 @@ int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capa
             */
             x[indexBestValue] = 1;
             // std::cout << "x[" << indexBestValue << "] := " << x[indexBestValue] << std::endl;
-			// check contraint 1
-			int statusCheck = checkSolution(x, objval, n, m, r, b, weights, profits, capacities, setups, classes, indexes);
+			// check contraint 1: the value 1 is kept only if the constraints hold, otherwise 0 (one free variable less each LP)
+			startPhase(params.perf, PERF_PHASE_CHECK);
+			int statusCheck = checkSolutionParallel(params.parallel, x, objval, n, m, r, b, weights, profits, capacities, setups, classes, indexes);
+			stopPhase(params.perf);
             //std::cout << "statusCheck = " << statusCheck << std::endl;
-			if (statusCheck == 1) {
-				bd[0] = 0;
-				indices[0] = indexBestValue;
-				status = CPXchgbds(env, lp, 1, indices, "B", bd);
-				if (status) {
-					std::cout << "error: GMKP failed to change CPX bounds...exiting" << std::endl;
-					exit(1);
-				}
-			} else if (statusCheck == 0) {
-                bd[0] = 1;
-                indices[0] = indexBestValue;
-                status = CPXchgbds(env, lp, 1, indices, "B", bd);
-                if (status) {
-                    std::cout << "error: GMKP failed to change CPX bounds...exiting" << std::endl;
-                    exit(1);
-                }
-            }
+			int value = statusCheck == 0 ? 1 : 0;
+			// a fixing that made an LP infeasible is not tried again
+			if (trail.noGoods[indexBestValue] & (1 << value))
+				value = 1 - value;
+			bd[0] = value;
+			indices[0] = indexBestValue;
+			status = changeBounds(env, lp, cols, 1, indices, "B", bd);
+			if (status) {
+				std::cerr << "error: GMKP failed to change CPX bounds" << std::endl;
+				return GMKP_ERROR_BOUNDS;
+			}
+			boundChanges++;
+			decision = indexBestValue * 2 + value;
 		}
 
-		//
-
-#ifndef NDEBUG
-		status = CPXwriteprob(env, lp, modelFilename, NULL);
-		if (status) {
-			std::cout << "error: GMKP failed to write MODEL file" << std::endl;
+		if (report != NULL) {
+			record.iteration = iteration - 1;
+			record.objval = objval;
+			record.fractionalX = fractionalX;
+			record.fractionalY = fractionalY;
+			record.index = allInt ? -1 : indexBestValue;
+			record.value = allInt ? 0 : bestValue;
+			record.statusCheck = statusCheck;
+			record.boundChanges = boundChanges;
+			record.lpTime = lpTime;
+			record.simplexIterations = simplexIterations;
+			report->iteration(record);
 		}
-#endif
+
+		//
 
 #ifndef NDEBUG
-		status = CPXsetlogfilename(env, logFilename, "w");
+		// with a journal the model is not written again (the log is opened once by solve)
+		status = params.modelFilename != NULL && journal.file == NULL ? CPXwriteprob(env, lp, params.modelFilename, NULL) : 0;
 		if (status) {
-			std::cout << "error: GMKP failed to write LOG file" << std::endl;
+			std::cerr << "error: GMKP failed to write MODEL file" << std::endl;
 		}
 #endif
 
 
-        cplexComputeSolution(env, lp, solstat, x, status, objval, objval_p);
-        statusCheck = checkSolution(x, objval, n, m, r, b, weights, profits, capacities, setups, classes, indexes);
-        printStatusMsg(statusCheck, iteration);
+        status = recordLevel(env, lp, trail, decision);
+        if (status)
+            return status;
+
+        lpStart = wallClock();
+        startPhase(params.perf, PERF_PHASE_LP);
+        status = cplexComputeSolution(env, lp, solstat, x, objval, objval_p, cols);
+        stopPhase(params.perf);
+        if (!status)
+            status = appendJournal(journal, env, lp, solstat, objval, wallClock() - lpStart);
+        if (status)
+            return status;
+
+        // infeasible: undo the fixings up to the last decision in the conflict and fix its opposite value
+        while (lpInfeasible(solstat)) {
+            int level = backjump(env, lp, trail, params.stats, status);
+            if (status)
+                return status;
+            if (level < 0) {
+                if (warmStart != NULL)
+                    std::cerr << "error: GMKP LP infeasible with the fixings of the warm start" << std::endl;
+                else
+                    std::cerr << "error: GMKP LP infeasible with no decision of the dive left to undo" << std::endl;
+                return GMKP_ERROR_INFEASIBLE;
+            }
+            if (params.stats != NULL)
+                params.stats->conflicts++;
+            if (params.verbose)
+                std::cout << "Iteration " << iteration << ": LP infeasible, the fixings from the LP " << level + 2 << " on are undone" << std::endl;
+            if (level <= classesLevel) {
+                flag = false;
+                subsolved = false;
+                classesLevel = -1;
+            }
+            double resolveStart = wallClock();
+            startPhase(params.perf, PERF_PHASE_LP);
+            status = cplexComputeSolution(env, lp, solstat, x, objval, objval_p, cols);
+            stopPhase(params.perf);
+            if (!status)
+                status = appendJournal(journal, env, lp, solstat, objval, wallClock() - resolveStart);
+            if (status)
+                return status;
+        }
+        snapLpSolution(x, n, m, r, params.integralityTolerance, params.stats);
+        lpTime = wallClock() - lpStart;
+        lpTimeTotal += lpTime;
+        simplexIterations = CPXgetitcnt(env, lp);
+        startPhase(params.perf, PERF_PHASE_CHECK);
+        statusCheck = checkSolutionParallel(params.parallel, x, objval, n, m, r, b, weights, profits, capacities, setups, classes, indexes);
+        stopPhase(params.perf);
+        if (params.verbose)
+            printStatusMsg(statusCheck, iteration);
+
+        if (pool != NULL)
+            collectSolution(pool, current, x, xRounded, wallClock() - solveStart, n, m, r, b, weights, profits, params.profitStore, capacities, setups, classes, indexes);
 
         iteration++;
+	}
 
-		truncated = (int)objval;
+	if (params.stats != NULL && cols != NULL) {
+		params.stats->columns = (int)cols->fullIndex.size() - m*r;
+		params.stats->pricingRounds = cols->rounds;
 	}
 
 	// print output
-	std::cout << "Result: " << objval << std::endl;
-	std::cout << "Elapsed time: " << time << std::endl;
-
-	delete[] x;
-	delete[] indices;
-	delete[] bd;
+	if (params.verbose) {
+		std::cout << "Result: " << objval << std::endl;
+		std::cout << "Elapsed time: " << time << std::endl;
+		if (params.stats != NULL)
+			std::cout << "LPs: " << params.stats->lps << ", values within the tolerance: " << params.stats->snappedValues << ", re-solves saved by the tolerance: " << params.stats->savedResolves << std::endl;
+		if (params.stats != NULL && params.stats->conflicts > 0)
+			std::cout << "Infeasible LPs: " << params.stats->conflicts << ", fixings undone: " << params.stats->undoneFixings << ", no-goods: " << params.stats->noGoods << std::endl;
+		if (params.stats != NULL && cols != NULL)
+			std::cout << "Columns x: " << params.stats->columns << " of " << n*m << ", pricing rounds: " << params.stats->pricingRounds << std::endl;
+	}
 
-	//
+	if (report != NULL) {
+		// last LP solution (no variable is fixed)
+		record.iteration = iteration - 1;
+		record.objval = objval;
+		record.fractionalX = countFractional(x, 0, n*m);
+		record.fractionalY = countFractional(x, n*m, n*m + m*r);
+		record.index = -1;
+		record.value = 0;
+		record.statusCheck = statusCheck;
+		record.boundChanges = 0;
+		record.lpTime = lpTime;
+		record.simplexIterations = simplexIterations;
+		report->iteration(record);
+
+		TraceSummary summary;
+		summary.objval = objval;
+		summary.iterations = iteration - 1;
+		summary.lpTime = lpTimeTotal;
+		summary.time = wallClock() - solveStart;
+		summary.status = status;
+		summary.savedResolves = params.stats != NULL ? params.stats->savedResolves : -1;
+		report->summary(summary);
+	}
 
-	/* free CPLEX */
-	CPXfreeprob(env, &lp);
+	// final assignment
+	collectSolution(NULL, solution, x, xRounded, wallClock() - solveStart, n, m, r, b, weights, profits, params.profitStore, capacities, setups, classes, indexes);
+	if (pool != NULL)
+		addToPool(*pool, solution);
 
-	CPXcloseCPLEX(&env);
+	// the warm start is the incumbent if the dive did not find anything better
+	if (warmStart != NULL && warmStart->status == 0 && (solution.status != 0 || solution.objval < warmStart->objval))
+		copySolution(*warmStart, solution);
 
 	return status;
 }
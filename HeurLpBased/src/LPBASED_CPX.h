@@ -8,8 +8,67 @@
 #include <fstream>
 #include <sstream>
 
+#include "GMKP.h"
 #include "CHECK_CONS_V2.h"
+#include "UTILITY.h"
+#include "REPORT.h"
+#include "SOLUTION.h"
+#include "KNAPSACK.h"
+#include "PARALLEL.h"
+#include "COLUMNS.h"
+#include "SYMMETRY.h"
+#include "PROFITS.h"
+#include "JOURNAL.h"
 
-int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, char * modelFilename, char * logFilename, int TL);
+struct Model;
+
+// columns given to CPLEX by each CPXnewcols of the model build
+#define BUILD_COLUMN_BLOCK (1 << 20)
+
+// add the columns x(i,j), y(i,k) and the constraints (1)-(4) of the GMKP to an empty lp (0 or GMKP_ERROR_MODEL)
+// the arrays of the n*m rows are filled by the threads of plan (NULL: by the caller)
+// the objective is decoded from store if not NULL (profits is not read), from profits otherwise
+int buildModel(CPXENVptr env, CPXLPptr lp, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, const ParallelPlan *plan, const CompressedProfits *store);
+
+// counters of the dive
+struct DiveStatistics {
+	int lps; // LPs solved
+	int snappedValues; // LP values within the integrality tolerance of 0 or 1 but not equal to it
+	int savedResolves; // LPs whose dive variable was one of these values: an LP saved by the tolerance each
+	int conflicts; // infeasible LPs after a fixing
+	int undoneFixings; // bounds restored by the backjumps
+	int noGoods; // fixings recorded as not to be tried again
+	int columns; // x columns in the lp at the end (n*m without column generation)
+	int pricingRounds; // pricing rounds that added columns
+};
+
+struct SolveParameters {
+	char *modelFilename; // model written after each LP in debug builds, unless there is a journal (NULL: not written)
+	char *logFilename; // CPLEX log of the whole solve in debug builds (NULL: not written)
+	char *journalFilename; // base model and bound changes of each LP of the dive (see JOURNAL.h), NULL: none; not with column generation
+	int TL; // time limit of each LP in seconds (0: none)
+	double timeLimit; // time limit of the whole dive in seconds (0: none), the dive stops with the last LP solution
+	int iterationLimit; // fixings and LPs of the dive after the root LP at most (0: none), the same for any machine load
+	RunReport *report; // trace of the dive (NULL: none)
+	SolutionPool *pool; // if not NULL, collects the best solutions met during the dive
+	Solution *warmStart; // if not NULL, a feasible solution: it is the starting incumbent and its items and classes are fixed to 1 (its identical knapsacks may be permuted)
+	bool exactSubproblems; // when all y are fixed the remaining knapsacks are solved by the exact subsolver instead of the dive
+	CPXENVptr env; // environment opened by the caller and kept open (NULL: solve opens and closes its own)
+	Model *model; // model kept between the solves (see MODEL.h), NULL: solve builds and frees its own lp
+	bool verbose; // print the checker verdict of each iteration and the result
+	double integralityTolerance; // LP values closer than this to 0 or 1 are set to it, the dive stops when no value is fractional
+	DiveStatistics *stats; // if not NULL, filled with the counters of the dive
+	ParallelPlan *parallel; // threads of the model build and of the checker on the LP solutions (NULL: one)
+	int columnGeneration; // x of each class in each knapsack in the starting restricted master (0: full model, ignored with a kept model)
+	int columnBatch; // x added by a pricing round at most (0: n)
+	bool symmetry; // orbit ordering of the identical knapsacks (see SYMMETRY.h), not with a kept model
+	const CompressedProfits *profitStore; // profits compressed (see PROFITS.h): if not NULL, profits may be NULL; not with a kept model, a warm start or column generation
+	PerfCounters *perf; // hardware counters of the model build, x scan, checker and LP phases (see PERF.h), NULL: none
+};
+
+void initSolveParameters(SolveParameters &params);
+
+// solution is the LP solution of the dive rounded down; returns 0 or a GMKP_ERROR code (see GMKP.h)
+int solve(int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, SolveParameters &params, Solution &solution);
 
 #endif /* LPBASED_CPX_H_ */
\ No newline at end of file
@@ -0,0 +1,160 @@
+#include "MEMORY.h"
+
+// bytes of the arrays of the instance other than the profits: w, the items sorted by class, C, s, b and the class ends
+long long instanceBytes(int n, int m, int r) {
+	return ((long long)n * 2 + m + (long long)r * 3) * sizeof(int);
+}
+
+void estimateModel(int n, int m, int r, long long profitBytes, MemoryEstimate &estimate) {
+	long long nm = (long long)n * m;
+	long long columns = nm + (long long)m * r;
+	long long rows = (long long)m + n + r + nm;
+	// constraints (1) to (4), and the orbit rows of the identical knapsacks at most
+	long long nonzeros = 4 * nm + 2 * (long long)m * r + std::min(SYMMETRY_MAX_NONZEROS, (long long)r * m * (m + 1) / 2);
+
+	estimate.instance = profitBytes + instanceBytes(n, m, r);
+	estimate.model = columns * MEMORY_CPX_COLUMN + rows * MEMORY_CPX_ROW + nonzeros * MEMORY_CPX_NONZERO;
+
+	// a block of columns (obj, lb, ub), the constraint (1) with all the columns and the constraint (4) with 2 nonzeros in each row
+	long long columnBlock = std::min(columns, (long long)BUILD_COLUMN_BLOCK) * 3 * sizeof(double);
+	long long capacityRows = (long long)m * (sizeof(int) + sizeof(double) + sizeof(char)) + columns * (sizeof(int) + sizeof(double));
+	long long linkRows = nm * (sizeof(int) + sizeof(double) + sizeof(char)) + 2 * nm * (sizeof(int) + sizeof(double));
+#ifndef NDEBUG
+	// names of the columns and of the rows
+	columnBlock += std::min(columns, (long long)BUILD_COLUMN_BLOCK) * (100 + sizeof(char *));
+	linkRows += nm * (100 + sizeof(char *));
+#endif
+	estimate.build = std::max(columnBlock, std::max(capacityRows, linkRows));
+
+	// x and x rounded, the indices and bounds of a fixing
+	estimate.dive = columns * (2 * sizeof(double) + sizeof(int) + sizeof(double));
+	estimate.columns = columns;
+
+	estimate.peak = MEMORY_PROCESS + estimate.instance + estimate.model + std::max(estimate.build, estimate.dive);
+}
+
+long long estimateBranchAndBound(const MemoryEstimate &estimate, int threads, long long nodeLimit) {
+	threads = std::max(1, threads);
+	// the siblings of a path have 1 ... columns bound changes (as double: columns^2 may not fit)
+	double path = (double)estimate.columns * nodeMemory(0) + (double)sizeof(int) * estimate.columns * (estimate.columns + 1) / 2;
+	long long nodes = (long long)std::min((double)nodeLimit, threads * path);
+	return MEMORY_PROCESS + estimate.instance + threads * (MEMORY_ENVIRONMENT + estimate.model + std::max(estimate.build, estimate.dive)) + nodes;
+}
+
+long long estimateDecomposed(int n, int m, int r, int largestClass, int parts, int threads) {
+	parts = std::max(1, std::min(parts, r));
+	threads = std::max(1, std::min(threads, parts));
+
+	// a part has at most one class above its share of the items, and not more classes than items
+	int partItems = (int)std::min((long long)n, ((long long)n + parts - 1) / parts + largestClass);
+	int partClasses = std::min(r, partItems);
+	MemoryEstimate part;
+	estimateModel(partItems, m, partClasses, (long long)partItems * m * sizeof(int), part);
+
+	long long profits = (long long)n * m * sizeof(int);
+	long long dives = MEMORY_PROCESS + profits + instanceBytes(n, m, r) + profits + threads * (MEMORY_ENVIRONMENT + part.model + std::max(part.build, part.dive));
+	// the improvement pass after the dives: x of the merged solution
+	long long improvement = MEMORY_PROCESS + profits + instanceBytes(n, m, r) + ((long long)n * m + (long long)m * r) * sizeof(double);
+	return std::max(dives, improvement);
+}
+
+long long estimateFormulation(int formulation, int n, int m, int r, int * profits, int * indexes, int parts, int threads, int bnbThreads, long long bnbMemory) {
+
+	if (formulation == MEMORY_DECOMPOSE) {
+		int largestClass = 0;
+		for (int k = 0; k < r; k++)
+			largestClass = std::max(largestClass, findCardinalityOfClass(k, indexes));
+		if (threads <= 0)
+			threads = (int)std::thread::hardware_concurrency();
+		return estimateDecomposed(n, m, r, largestClass, parts, threads);
+	}
+
+	long long ints = (long long)n * m * sizeof(int);
+	MemoryEstimate model;
+	estimateModel(n, m, r, formulation == MEMORY_COMPRESSED ? compressedBytes(n, m, profits) : ints, model);
+	long long estimate = model.peak;
+	// the ints and the compressed profits are both in memory while the profits are compressed
+	if (formulation == MEMORY_COMPRESSED)
+		estimate = std::max(estimate, MEMORY_PROCESS + ints + model.instance);
+	if (bnbThreads > 0)
+		estimate = std::max(estimate, estimateBranchAndBound(model, bnbThreads, bnbMemory));
+	return estimate;
+}
+
+bool planMemory(long long limit, int n, int m, int r, int * profits, int * indexes, bool compressible, bool decomposable, int bnbThreads, long long bnbMemory, MemoryPlan &plan) {
+
+	plan.formulation = MEMORY_FULL;
+	plan.parts = 0;
+	plan.threads = 0;
+	plan.bnbThreads = bnbThreads;
+	plan.bnbMemory = bnbMemory;
+	plan.estimate = estimateFormulation(MEMORY_FULL, n, m, r, profits, indexes, 0, 0, bnbThreads, bnbMemory);
+
+	if (bnbThreads > 0) {
+		// the nodes get what the dive and the lps of the threads leave, with the most threads that leave some
+		MemoryEstimate model;
+		estimateModel(n, m, r, (long long)n * m * sizeof(int), model);
+		for (int threads = bnbThreads; threads >= 1; threads--) {
+			long long left = limit - estimateBranchAndBound(model, threads, 0);
+			if (model.peak <= limit && left >= nodeMemory(0)) {
+				plan.bnbThreads = threads;
+				plan.bnbMemory = std::min(bnbMemory, left);
+				plan.estimate = std::max(model.peak, estimateBranchAndBound(model, threads, plan.bnbMemory));
+				return true;
+			}
+		}
+		plan.bnbThreads = 1;
+		plan.bnbMemory = nodeMemory(0);
+		plan.estimate = std::max(model.peak, estimateBranchAndBound(model, 1, plan.bnbMemory));
+		return false;
+	}
+
+	if (plan.estimate <= limit)
+		return true;
+
+	if (compressible) {
+		long long estimate = estimateFormulation(MEMORY_COMPRESSED, n, m, r, profits, indexes, 0, 0, 0, 0);
+		if (estimate < plan.estimate) {
+			plan.formulation = MEMORY_COMPRESSED;
+			plan.estimate = estimate;
+		}
+		if (estimate <= limit)
+			return true;
+	}
+
+	if (decomposable && r > 1) {
+		int largestClass = 0;
+		for (int k = 0; k < r; k++)
+			largestClass = std::max(largestClass, findCardinalityOfClass(k, indexes));
+		int cores = std::max(1, (int)std::thread::hardware_concurrency());
+
+		for (int parts = 2; parts <= r; parts++) {
+			for (int threads = std::min(cores, parts); threads >= 1; threads--) {
+				long long estimate = estimateDecomposed(n, m, r, largestClass, parts, threads);
+				if (estimate < plan.estimate) {
+					plan.formulation = MEMORY_DECOMPOSE;
+					plan.parts = parts;
+					plan.threads = threads;
+					plan.estimate = estimate;
+				}
+				if (estimate <= limit)
+					return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+const char *memoryFormulationName(int formulation) {
+	switch (formulation) {
+	case MEMORY_FULL:
+		return "full model";
+	case MEMORY_COMPRESSED:
+		return "compressed profits";
+	case MEMORY_DECOMPOSE:
+		return "decomposition";
+	default:
+		return "unknown";
+	}
+}
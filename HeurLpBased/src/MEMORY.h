@@ -0,0 +1,76 @@
+#include <iostream>
+#include <algorithm>
+#include <thread>
+
+#include "LPBASED_CPX.h"
+#include "BRANCHBOUND.h"
+
+#ifndef MEMORY_H_
+#define MEMORY_H_
+
+// formulations with a different footprint
+#define MEMORY_FULL 0 // full model, profits as ints
+#define MEMORY_COMPRESSED 1 // full model, profits compressed (see PROFITS.h)
+#define MEMORY_DECOMPOSE 2 // sub-instances solved at the same time (see DECOMPOSE.h)
+
+/* bytes of the CPLEX lp, upper guesses from its layout, not measured on CPLEX: each nonzero in the matrix by columns
+ * and by rows (index and value, 24 bytes) and as much again for the factorization; bounds, objective, solution,
+ * basis and scaling of each column and row
+ * the environments are counted at 32 MB each, on the safe side of the libraries and the simplex workspace of CPLEX:
+ * every run prints its peak next to the estimate, to compare them with the CPLEX in use
+ * */
+#define MEMORY_CPX_NONZERO 48
+#define MEMORY_CPX_COLUMN 64
+#define MEMORY_CPX_ROW 48
+#define MEMORY_PROCESS (32LL << 20) // process with its first CPLEX environment
+#define MEMORY_ENVIRONMENT (32LL << 20) // each other environment (threads of the branch and bound, sub-instances)
+
+// peak of the dive on the full model, in bytes
+struct MemoryEstimate {
+	long long instance; // arrays of the instance, profits as ints or compressed
+	long long model; // lp of CPLEX
+	long long build; // largest block of columns or rows being added by buildModel
+	long long dive; // vectors of the dive (x, x rounded, fixings)
+	long long columns; // x and y: bound changes of a path of the branch and bound at most
+	long long peak; // process + instance + model + the larger of build and dive
+};
+
+// profitBytes: n*m*4 for the ints, compressedBytes for the compressed profits
+void estimateModel(int n, int m, int r, long long profitBytes, MemoryEstimate &estimate);
+
+/* peak of the branch and bound after the dive: an environment and an lp for each thread, and the open siblings of
+ * the path of each thread (one node for each bound change, see nodeMemory), at most nodeLimit bytes of nodes;
+ * a best bound search may open more nodes than that, up to nodeLimit
+ * */
+long long estimateBranchAndBound(const MemoryEstimate &estimate, int threads, long long nodeLimit);
+
+/* peak of the decomposition: the instance, the profits of all the sub-instances and threads dives at the same time,
+ * each on a part of at most n/parts + largestClass items (the classes are not split)
+ * */
+long long estimateDecomposed(int n, int m, int r, int largestClass, int parts, int threads);
+
+struct MemoryPlan {
+	int formulation; // MEMORY_...
+	int parts; // sub-instances (MEMORY_DECOMPOSE)
+	int threads; // sub-instances solved at the same time (MEMORY_DECOMPOSE)
+	int bnbThreads; // threads of the branch and bound
+	long long bnbMemory; // bytes of the open nodes of the branch and bound
+	long long estimate; // peak in bytes
+};
+
+/* peak of a formulation: parts and threads of the decomposition (threads 0: one for each core), bnbThreads > 0 adds
+ * the branch and bound to the full model; the compressed size is computed from profits without compressing them
+ * */
+long long estimateFormulation(int formulation, int n, int m, int r, int * profits, int * indexes, int parts, int threads, int bnbThreads, long long bnbMemory);
+
+/* the first formulation whose estimate is not above limit: full model, compressed profits (if compressible),
+ * decomposition with the fewest parts, then the most threads (if decomposable); false if none fits, plan is then
+ * the formulation with the smallest estimate
+ * bnbThreads > 0: the full model with the branch and bound, with the most threads up to bnbThreads that fit;
+ * the memory of its open nodes is lowered to what the limit leaves, so that they cannot exceed it
+ * */
+bool planMemory(long long limit, int n, int m, int r, int * profits, int * indexes, bool compressible, bool decomposable, int bnbThreads, long long bnbMemory, MemoryPlan &plan);
+
+const char *memoryFormulationName(int formulation);
+
+#endif /* MEMORY_H_ */
@@ -0,0 +1,167 @@
+#include "MODEL.h"
+
+int *copyOf(const int *values, int size) {
+	int *copy = (int *)malloc(sizeof(int) * size);
+	for (int i = 0; i < size; i++)
+		copy[i] = values[i];
+	return copy;
+}
+
+int openModel(Model &model, CPXENVptr env, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes) {
+
+	int status = 0;
+
+	model.n = n;
+	model.m = m;
+	model.r = r;
+	model.env = env;
+	model.lp = NULL;
+	model.ownsEnv = env == NULL;
+	model.hasBasis = false;
+	model.solves = 0;
+
+	model.b = copyOf(b, r);
+	model.weights = copyOf(weights, n);
+	model.profits = copyOf(profits, n*m);
+	model.capacities = copyOf(capacities, m);
+	model.setups = copyOf(setups, r);
+	model.classes = copyOf(classes, n);
+	model.indexes = copyOf(indexes, r);
+	model.cstat = NULL;
+	model.rstat = NULL;
+
+	if (model.ownsEnv)
+		model.env = CPXopenCPLEX(&status);
+	if (status) {
+		std::cerr << "error: GMKP CPXopenCPLEX failed" << std::endl;
+		return GMKP_ERROR_ENVIRONMENT;
+	}
+
+	model.lp = CPXcreateprob(model.env, &status, "GMKP - Callable Library");
+	if (status) {
+		std::cerr << "error: GMKP CPXcreateprob failed" << std::endl;
+		return GMKP_ERROR_ENVIRONMENT;
+	}
+
+	status = buildModel(model.env, model.lp, n, m, r, b, weights, profits, capacities, setups, classes, indexes, NULL, NULL);
+
+	model.cstat = new int[n*m + m*r];
+	model.rstat = new int[CPXgetnumrows(model.env, model.lp)];
+
+	return status;
+}
+
+int changeCapacities(Model &model, int count, const int *knapsacks, const int *capacities) {
+
+	int *indices = new int[count];
+	double *values = new double[count];
+	for (int c = 0; c < count; c++) {
+		indices[c] = knapsacks[c]; // constraints (1) are the first m rows
+		values[c] = capacities[c];
+		model.capacities[knapsacks[c]] = capacities[c];
+	}
+
+	int status = count > 0 ? CPXchgrhs(model.env, model.lp, count, indices, values) : 0;
+	if (status)
+		std::cerr << "error: GMKP failed to change CPX right-hand side" << std::endl;
+
+	delete[] indices;
+	delete[] values;
+	return status ? GMKP_ERROR_MODEL : 0;
+}
+
+int changeProfits(Model &model, int count, const int *knapsacks, const int *items, const int *profits) {
+
+	int *indices = new int[count];
+	double *values = new double[count];
+	for (int c = 0; c < count; c++) {
+		indices[c] = knapsacks[c] * model.n + items[c];
+		values[c] = profits[c];
+		model.profits[indices[c]] = profits[c];
+	}
+
+	int status = count > 0 ? CPXchgobj(model.env, model.lp, count, indices, values) : 0;
+	if (status)
+		std::cerr << "error: GMKP failed to change CPX objective" << std::endl;
+
+	delete[] indices;
+	delete[] values;
+	return status ? GMKP_ERROR_MODEL : 0;
+}
+
+int changeClassLimits(Model &model, int count, const int *classes, const int *b) {
+
+	int *indices = new int[count];
+	double *values = new double[count];
+	for (int c = 0; c < count; c++) {
+		indices[c] = model.m + model.n + classes[c]; // constraints (3) follow the m rows (1) and the n rows (2)
+		values[c] = b[c];
+		model.b[classes[c]] = b[c];
+	}
+
+	int status = count > 0 ? CPXchgrhs(model.env, model.lp, count, indices, values) : 0;
+	if (status)
+		std::cerr << "error: GMKP failed to change CPX right-hand side" << std::endl;
+
+	delete[] indices;
+	delete[] values;
+	return status ? GMKP_ERROR_MODEL : 0;
+}
+
+int resetFixings(Model &model) {
+
+	int ccnt = model.n*model.m + model.m*model.r;
+	int *indices = new int[2 * ccnt];
+	char *lu = new char[2 * ccnt];
+	double *bd = new double[2 * ccnt];
+	for (int j = 0; j < ccnt; j++) {
+		indices[2*j] = j;
+		lu[2*j] = 'L';
+		bd[2*j] = 0;
+		indices[2*j + 1] = j;
+		lu[2*j + 1] = 'U';
+		bd[2*j + 1] = 1;
+	}
+
+	int status = CPXchgbds(model.env, model.lp, 2 * ccnt, indices, lu, bd);
+	if (status)
+		std::cerr << "error: GMKP failed to change CPX bounds" << std::endl;
+
+	delete[] indices;
+	delete[] lu;
+	delete[] bd;
+	return status ? GMKP_ERROR_BOUNDS : 0;
+}
+
+int solveModel(Model &model, SolveParameters &params, Solution &solution) {
+
+	// the first solve starts from the bounds of the build
+	int status = model.solves > 0 ? resetFixings(model) : 0;
+	if (status)
+		return status;
+
+	params.env = model.env;
+	params.model = &model;
+	status = solve(model.n, model.m, model.r, model.b, model.weights, model.profits, model.capacities, model.setups, model.classes, model.indexes, params, solution);
+	model.solves++;
+
+	return status;
+}
+
+void closeModel(Model &model) {
+
+	free(model.b);
+	free(model.weights);
+	free(model.profits);
+	free(model.capacities);
+	free(model.setups);
+	free(model.classes);
+	free(model.indexes);
+	delete[] model.cstat;
+	delete[] model.rstat;
+
+	if (model.lp != NULL)
+		CPXfreeprob(model.env, &model.lp);
+	if (model.ownsEnv && model.env != NULL)
+		CPXcloseCPLEX(&model.env);
+}
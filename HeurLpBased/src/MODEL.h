@@ -0,0 +1,54 @@
+#include <cstdlib>
+
+#include "LPBASED_CPX.h"
+
+#ifndef MODEL_H_
+#define MODEL_H_
+
+/* CPLEX model of an instance kept between the solves
+ * the changes of capacities, profits and b(k) are applied in place (rhs and objective), so the model is built once
+ * for each shape (n, m, r and the classes) and every solve starts from the optimal basis of the previous root LP
+ * */
+struct Model {
+	int n; // number of objects
+	int m; // number of knapsacks
+	int r; // number of subsets
+	CPXENVptr env;
+	CPXLPptr lp;
+	bool ownsEnv; // the environment is closed by closeModel
+	// copy of the instance with the changes applied (used by the checker and by the subsolver)
+	int *b;
+	int *weights;
+	int *profits;
+	int *capacities;
+	int *setups;
+	int *classes;
+	int *indexes;
+	// optimal basis of the first LP of the last solve
+	int *cstat;
+	int *rstat;
+	bool hasBasis;
+	int solves;
+};
+
+// build the model of the instance; env NULL: the model opens and closes its own environment
+int openModel(Model &model, CPXENVptr env, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes);
+
+// C_i of the given knapsacks (right-hand side of the constraints (1))
+int changeCapacities(Model &model, int count, const int *knapsacks, const int *capacities);
+
+// p(i,j) of the given pairs (objective of x(i,j))
+int changeProfits(Model &model, int count, const int *knapsacks, const int *items, const int *profits);
+
+// b(k) of the given classes (right-hand side of the constraints (3))
+int changeClassLimits(Model &model, int count, const int *classes, const int *b);
+
+// remove the bounds fixed by the dive (and by the warm start): all the columns back to [0, 1]
+int resetFixings(Model &model);
+
+// reset the fixings and run the dive of solve() on the kept model (params.env and params.model are set here)
+int solveModel(Model &model, SolveParameters &params, Solution &solution);
+
+void closeModel(Model &model);
+
+#endif /* MODEL_H_ */
@@ -0,0 +1,77 @@
+#include "OUTPUT.h"
+
+BufferedWriter::BufferedWriter(FILE *file, size_t capacity) {
+	this->file = file;
+	this->capacity = capacity;
+	this->size = 0;
+	this->buffer = (char *)malloc(capacity);
+}
+
+BufferedWriter::~BufferedWriter() {
+	flush();
+	free(buffer);
+}
+
+void BufferedWriter::write(const char *str) {
+	write(str, strlen(str));
+}
+
+void BufferedWriter::write(const char *data, size_t length) {
+	if (size + length > capacity) {
+		flush();
+		// the data are bigger than the buffer: write them directly
+		if (length > capacity) {
+			fwrite(data, 1, length, file);
+			return;
+		}
+	}
+
+	memcpy(buffer + size, data, length);
+	size += length;
+}
+
+void BufferedWriter::write(char c) {
+	if (size == capacity)
+		flush();
+	buffer[size++] = c;
+}
+
+void BufferedWriter::write(int value) {
+	write((long long)value);
+}
+
+void BufferedWriter::write(long long value) {
+	char digits[24];
+	int length = 0;
+	bool negative = value < 0;
+	unsigned long long u = negative ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+
+	do {
+		digits[length++] = '0' + (char)(u % 10);
+		u /= 10;
+	} while (u > 0);
+	if (negative)
+		digits[length++] = '-';
+
+	if (size + length > capacity)
+		flush();
+	while (length > 0)
+		buffer[size++] = digits[--length];
+}
+
+void BufferedWriter::write(double value) {
+	char str[32];
+	int length = snprintf(str, sizeof(str), "%.10g", value);
+	write(str, (size_t)length);
+}
+
+void BufferedWriter::writeRaw(const void *data, size_t length) {
+	write((const char *)data, length);
+}
+
+void BufferedWriter::flush() {
+	if (size > 0) {
+		fwrite(buffer, 1, size, file);
+		size = 0;
+	}
+}
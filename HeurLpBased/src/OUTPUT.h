@@ -0,0 +1,33 @@
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+#ifndef OUTPUT_H_
+#define OUTPUT_H_
+
+// writer that collects the output in a memory buffer and flushes it only when the buffer is full
+class BufferedWriter {
+public:
+	BufferedWriter(FILE *file, size_t capacity = 1 << 20);
+	~BufferedWriter();
+
+	void write(const char *str);
+	void write(const char *data, size_t length);
+	void write(char c);
+	void write(int value);
+	void write(long long value);
+	void write(double value);
+
+	// write the bytes of a memory area as they are (binary files)
+	void writeRaw(const void *data, size_t length);
+
+	void flush();
+
+private:
+	FILE *file;
+	char *buffer;
+	size_t capacity;
+	size_t size;
+};
+
+#endif /* OUTPUT_H_ */
@@ -0,0 +1,135 @@
+#include "PARALLEL.h"
+
+// cores of a list like "0-15,32-47"
+std::vector<int> parseCpuList(const char *list) {
+	std::vector<int> cpus;
+	const char *p = list;
+	while (*p) {
+		char *end;
+		long first = strtol(p, &end, 10);
+		if (end == p)
+			break;
+		long last = first;
+		p = end;
+		if (*p == '-') {
+			last = strtol(p + 1, &end, 10);
+			p = end;
+		}
+		for (long c = first; c <= last; c++)
+			cpus.push_back((int)c);
+		while (*p == ',' || *p == '\n' || *p == ' ')
+			p++;
+	}
+	return cpus;
+}
+
+// cores allowed to the process of each NUMA node (one node with all the cores without /sys)
+std::vector<std::vector<int>> readNumaNodes() {
+	std::vector<int> allowed;
+#ifdef __linux__
+	cpu_set_t mask;
+	if (sched_getaffinity(0, sizeof(mask), &mask) == 0)
+		for (int c = 0; c < CPU_SETSIZE; c++)
+			if (CPU_ISSET(c, &mask))
+				allowed.push_back(c);
+#endif
+
+	std::vector<std::vector<int>> nodes;
+	char line[4096];
+	FILE *online = fopen("/sys/devices/system/node/online", "r");
+	if (online != NULL) {
+		std::vector<int> ids;
+		if (fgets(line, sizeof(line), online) != NULL)
+			ids = parseCpuList(line);
+		fclose(online);
+
+		for (size_t d = 0; d < ids.size(); d++) {
+			char path[128];
+			snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", ids[d]);
+			FILE *file = fopen(path, "r");
+			if (file == NULL)
+				continue;
+			std::vector<int> cpus;
+			if (fgets(line, sizeof(line), file) != NULL)
+				cpus = parseCpuList(line);
+			fclose(file);
+
+			std::vector<int> usable;
+			for (size_t c = 0; c < cpus.size(); c++)
+				if (allowed.empty() || std::find(allowed.begin(), allowed.end(), cpus[c]) != allowed.end())
+					usable.push_back(cpus[c]);
+			if (!usable.empty())
+				nodes.push_back(usable);
+		}
+	}
+
+	if (nodes.empty()) {
+		if (allowed.empty())
+			for (int c = 0; c < (int)std::thread::hardware_concurrency(); c++)
+				allowed.push_back(c);
+		nodes.push_back(allowed);
+	}
+	return nodes;
+}
+
+void initParallelPlan(ParallelPlan &plan, int threads) {
+	std::vector<std::vector<int>> nodes = readNumaNodes();
+
+	int cores = 0;
+	for (size_t d = 0; d < nodes.size(); d++)
+		cores += (int)nodes[d].size();
+	if (threads <= 0)
+		threads = cores > 0 ? cores : 1;
+
+	plan.threads = threads;
+	plan.cpus.assign(threads, -1);
+	plan.threadNodes.assign(threads, 0);
+
+	// the threads of a node take its cores in order (more threads than cores: the cores are shared)
+	std::vector<int> used(nodes.size(), 0);
+	for (int t = 0; t < threads; t++) {
+		int d = (int)((long long)t * nodes.size() / threads);
+		plan.threadNodes[t] = d;
+		if (!nodes[d].empty())
+			plan.cpus[t] = nodes[d][used[d]++ % nodes[d].size()];
+	}
+	plan.nodes = std::min((int)nodes.size(), threads);
+}
+
+void pinThread(int cpu) {
+#ifdef __linux__
+	if (cpu < 0)
+		return;
+	cpu_set_t mask;
+	CPU_ZERO(&mask);
+	CPU_SET(cpu, &mask);
+	pthread_setaffinity_np(pthread_self(), sizeof(mask), &mask);
+#endif
+}
+
+void parallelBlocks(const ParallelPlan *plan, long long count, long long unitSize, const std::function<void(int, long long, long long)> &task) {
+
+	int threads = plan != NULL ? plan->threads : 1;
+	if (threads > count * unitSize / PARALLEL_MIN_BLOCK)
+		threads = (int)(count * unitSize / PARALLEL_MIN_BLOCK);
+	if (threads > count)
+		threads = (int)count;
+
+	if (threads <= 1) {
+		task(0, 0, count);
+		return;
+	}
+
+	std::vector<std::thread> workers;
+	for (int t = 0; t < threads; t++) {
+		long long begin = count * t / threads;
+		long long end = count * (t + 1) / threads;
+		int cpu = plan->cpus[t];
+		workers.push_back(std::thread([&task, t, begin, end, cpu]() {
+			pinThread(cpu);
+			task(t, begin, end);
+		}));
+	}
+	for (size_t t = 0; t < workers.size(); t++)
+		workers[t].join();
+}
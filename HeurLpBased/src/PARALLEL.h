@@ -0,0 +1,38 @@
+#include <vector>
+#include <thread>
+#include <functional>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#ifndef PARALLEL_H_
+#define PARALLEL_H_
+
+// a pass is split only if each thread gets at least this number of elements
+#define PARALLEL_MIN_BLOCK (1LL << 15)
+
+/* threads of the passes over the n*m data (model build, checker), spread over the NUMA nodes:
+ * the thread t is pinned to a core of the node t * nodes / threads, so consecutive blocks of a pass
+ * (the knapsacks of the x columns) are on the same node; the arrays written by a pass are touched
+ * for the first time by the thread of their block, so their pages are allocated on its node
+ * */
+struct ParallelPlan {
+	int threads;
+	int nodes; // NUMA nodes with at least one thread
+	std::vector<int> cpus; // core of each thread (-1: not pinned)
+	std::vector<int> threadNodes; // node of each thread
+};
+
+// threads 0: one for each core allowed to the process
+void initParallelPlan(ParallelPlan &plan, int threads);
+
+// task(thread, begin, end) on consecutive blocks of the units [0, count), each of unitSize elements (e.g. a knapsack: n)
+// in the caller if plan is NULL, has one thread or the pass is short
+void parallelBlocks(const ParallelPlan *plan, long long count, long long unitSize, const std::function<void(int, long long, long long)> &task);
+
+#endif /* PARALLEL_H_ */
@@ -0,0 +1,158 @@
+#include "PERF.h"
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+const char *PERF_PHASE_NAMES[PERF_PHASES] = {"build", "scan", "check", "lp"};
+const char *PERF_EVENT_NAMES[PERF_EVENTS] = {"cycles", "instructions", "l1_misses", "llc_misses", "branch_misses"};
+
+const char *perfPhaseName(int phase) {
+	return phase >= 0 && phase < PERF_PHASES ? PERF_PHASE_NAMES[phase] : "unknown";
+}
+
+const char *perfEventName(int event) {
+	return event >= 0 && event < PERF_EVENTS ? PERF_EVENT_NAMES[event] : "unknown";
+}
+
+#ifdef __linux__
+int openEvent(unsigned int type, unsigned long long config) {
+	struct perf_event_attr attr;
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = type;
+	attr.config = config;
+	attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+	attr.inherit = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return (int)syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+// value scaled by the time the event was on the PMU (the events are multiplexed when they are more than the counters)
+long long readEvent(int fd) {
+	unsigned long long values[3];
+	if (read(fd, values, sizeof(values)) != (ssize_t)sizeof(values))
+		return -1;
+	if (values[2] == 0)
+		return 0;
+	if (values[2] < values[1])
+		return (long long)((double)values[0] * values[1] / values[2]);
+	return (long long)values[0];
+}
+#endif
+
+int openPerfCounters(PerfCounters &perf) {
+	perf.available = 0;
+	perf.running = -1;
+	perf.startTime = 0;
+	for (int e = 0; e < PERF_EVENTS; e++) {
+		perf.fds[e] = -1;
+		perf.start[e] = 0;
+	}
+	for (int p = 0; p < PERF_PHASES; p++) {
+		perf.phases[p].calls = 0;
+		perf.phases[p].time = 0;
+		for (int e = 0; e < PERF_EVENTS; e++)
+			perf.phases[p].counts[e] = 0;
+	}
+
+#ifdef __linux__
+	const unsigned long long readMiss = PERF_COUNT_HW_CACHE_OP_READ << 8 | PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+	perf.fds[PERF_CYCLES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES);
+	perf.fds[PERF_INSTRUCTIONS] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS);
+	perf.fds[PERF_L1_MISSES] = openEvent(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | readMiss);
+	perf.fds[PERF_LLC_MISSES] = openEvent(PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_LL | readMiss);
+	perf.fds[PERF_BRANCH_MISSES] = openEvent(PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES);
+#endif
+
+	for (int e = 0; e < PERF_EVENTS; e++) {
+		if (perf.fds[e] >= 0)
+			perf.available++;
+		else
+			for (int p = 0; p < PERF_PHASES; p++)
+				perf.phases[p].counts[e] = -1;
+	}
+	return perf.available;
+}
+
+void closePerfCounters(PerfCounters &perf) {
+	stopPhase(&perf);
+	for (int e = 0; e < PERF_EVENTS; e++) {
+#ifdef __linux__
+		if (perf.fds[e] >= 0)
+			close(perf.fds[e]);
+#endif
+		perf.fds[e] = -1;
+	}
+}
+
+void startPhase(PerfCounters *perf, int phase) {
+	if (perf == NULL)
+		return;
+	if (perf->running >= 0)
+		stopPhase(perf);
+
+	perf->running = phase;
+	perf->startTime = wallClock();
+#ifdef __linux__
+	for (int e = 0; e < PERF_EVENTS; e++)
+		if (perf->fds[e] >= 0)
+			perf->start[e] = readEvent(perf->fds[e]);
+#endif
+}
+
+void stopPhase(PerfCounters *perf) {
+	if (perf == NULL || perf->running < 0)
+		return;
+
+	PerfPhase &phase = perf->phases[perf->running];
+#ifdef __linux__
+	for (int e = 0; e < PERF_EVENTS; e++) {
+		if (perf->fds[e] < 0)
+			continue;
+		long long value = readEvent(perf->fds[e]);
+		if (value >= perf->start[e] && perf->start[e] >= 0)
+			phase.counts[e] += value - perf->start[e];
+	}
+#endif
+	phase.time += wallClock() - perf->startTime;
+	phase.calls++;
+	perf->running = -1;
+}
+
+void printPerfCounters(const PerfCounters &perf) {
+	if (perf.available == 0)
+		std::cout << "Hardware counters not available (perf_event_open failed): wall times only" << std::endl;
+
+	char line[512];
+	snprintf(line, sizeof(line), "%-6s %8s %10s %16s %16s %6s %12s %12s %12s", "phase", "calls", "time", "cycles", "instructions", "IPC", "L1 miss/Ki", "LLC miss/Ki", "br miss/Ki");
+	std::cout << line << std::endl;
+	for (int p = 0; p < PERF_PHASES; p++) {
+		const PerfPhase &phase = perf.phases[p];
+		if (phase.calls == 0)
+			continue;
+
+		// counts, then the ratios to the instructions ("-": not available)
+		char values[PERF_EVENTS][32];
+		for (int e = 0; e < PERF_EVENTS; e++) {
+			if (phase.counts[e] < 0)
+				strcpy(values[e], "-");
+			else if (e <= PERF_INSTRUCTIONS)
+				snprintf(values[e], sizeof(values[e]), "%lld", phase.counts[e]);
+			else if (phase.counts[PERF_INSTRUCTIONS] > 0)
+				snprintf(values[e], sizeof(values[e]), "%.3f", 1000.0 * phase.counts[e] / phase.counts[PERF_INSTRUCTIONS]);
+			else
+				strcpy(values[e], "-");
+		}
+		char ipc[32] = "-";
+		if (phase.counts[PERF_CYCLES] > 0 && phase.counts[PERF_INSTRUCTIONS] >= 0)
+			snprintf(ipc, sizeof(ipc), "%.2f", (double)phase.counts[PERF_INSTRUCTIONS] / phase.counts[PERF_CYCLES]);
+
+		snprintf(line, sizeof(line), "%-6s %8lld %10.4f %16s %16s %6s %12s %12s %12s", perfPhaseName(p), phase.calls, phase.time, values[PERF_CYCLES], values[PERF_INSTRUCTIONS], ipc, values[PERF_L1_MISSES], values[PERF_LLC_MISSES], values[PERF_BRANCH_MISSES]);
+		std::cout << line << std::endl;
+	}
+}
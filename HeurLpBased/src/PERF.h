@@ -0,0 +1,60 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+
+#include "UTILITY.h"
+
+#ifndef PERF_H_
+#define PERF_H_
+
+// phases of solve() measured by the counters
+#define PERF_PHASE_BUILD 0 // arrays of the columns and rows and their copy in the lp
+#define PERF_PHASE_SCAN 1 // scan of the y and x of each LP solution of the dive
+#define PERF_PHASE_CHECK 2 // checker on the LP solutions
+#define PERF_PHASE_LP 3 // LP solves
+#define PERF_PHASES 4
+
+// hardware events of each phase
+#define PERF_CYCLES 0
+#define PERF_INSTRUCTIONS 1
+#define PERF_L1_MISSES 2 // L1 data cache read misses
+#define PERF_LLC_MISSES 3 // last level cache read misses
+#define PERF_BRANCH_MISSES 4
+#define PERF_EVENTS 5
+
+struct PerfPhase {
+	long long calls;
+	double time; // wall time (seconds)
+	long long counts[PERF_EVENTS]; // -1: event not available
+};
+
+/* hardware counters of the phases (Linux perf_event_open, user space only): the counters are opened for the
+ * calling thread and inherited by the threads it starts later (the blocks of the model build and of the checker);
+ * an event that cannot be opened (no PMU in a virtual machine, perf_event_paranoid, not Linux) is left out
+ * and the phases keep only their wall time
+ * */
+struct PerfCounters {
+	int fds[PERF_EVENTS]; // -1: not opened
+	int available; // events opened
+	int running; // phase started (-1: none)
+	double startTime;
+	long long start[PERF_EVENTS];
+	PerfPhase phases[PERF_PHASES];
+};
+
+// returns the number of events opened (0: only wall times)
+int openPerfCounters(PerfCounters &perf);
+
+void closePerfCounters(PerfCounters &perf);
+
+// nothing when perf is NULL; a phase started while another one is running stops it
+void startPhase(PerfCounters *perf, int phase);
+void stopPhase(PerfCounters *perf);
+
+const char *perfPhaseName(int phase);
+const char *perfEventName(int event);
+
+// one line for each phase: calls, time, events, IPC and misses per thousand instructions
+void printPerfCounters(const PerfCounters &perf);
+
+#endif /* PERF_H_ */
@@ -0,0 +1,146 @@
+#include "PROFITS.h"
+
+// plain loops on contiguous values: vectorized by the compiler (widening loads, then the conversion)
+template <typename T, typename V>
+void decodeRow(const T *row, int base, int begin, int end, V *values) {
+	for (int j = begin; j < end; j++)
+		values[j - begin] = (V)(base + (int)row[j]);
+}
+
+// 4 bytes: the range of the row may not fit in an int
+template <typename V>
+void decodeRow(const uint32_t *row, int base, int begin, int end, V *values) {
+	for (int j = begin; j < end; j++)
+		values[j - begin] = (V)(base + (long long)row[j]);
+}
+
+template <typename V>
+void decodeProfitsRow(const CompressedProfits &store, int i, int begin, int end, V *values) {
+	const unsigned char *row = store.data.data() + store.offset[i];
+	if (store.width[i] == 1)
+		decodeRow(row, store.base[i], begin, end, values);
+	else if (store.width[i] == 2)
+		decodeRow((const uint16_t *)row, store.base[i], begin, end, values);
+	else
+		decodeRow((const uint32_t *)row, store.base[i], begin, end, values);
+}
+
+void decodeProfits(const CompressedProfits &store, int i, int begin, int end, int *values) {
+	decodeProfitsRow(store, i, begin, end, values);
+}
+
+void decodeProfits(const CompressedProfits &store, int i, int begin, int end, double *values) {
+	decodeProfitsRow(store, i, begin, end, values);
+}
+
+template <typename T>
+void encodeRow(const int *profits, int base, int n, unsigned char *data) {
+	T *row = (T *)data;
+	for (int j = 0; j < n; j++)
+		row[j] = (T)((long long)profits[j] - base);
+}
+
+// bytes of each value of the row from its range; low is its smallest profit
+unsigned char rowWidth(const int *row, int n, int &low) {
+	low = n > 0 ? row[0] : 0;
+	int high = low;
+	for (int j = 1; j < n; j++) {
+		low = std::min(low, row[j]);
+		high = std::max(high, row[j]);
+	}
+	long long range = (long long)high - low;
+	return range <= UINT8_MAX ? 1 : range <= UINT16_MAX ? 2 : 4;
+}
+
+// rows start at multiples of 8 bytes, so the 2 and 4 byte values are aligned
+long long rowBytes(int n, int width) {
+	return ((long long)n * width + 7) & ~7LL;
+}
+
+void compressProfits(int n, int m, const int *profits, const ParallelPlan *plan, CompressedProfits &store) {
+	store.n = n;
+	store.m = m;
+	store.base.assign(m, 0);
+	store.width.assign(m, 4);
+	store.offset.assign(m + 1, 0);
+
+	// range of each row
+	parallelBlocks(plan, m, n, [&](int, long long begin, long long end) {
+		for (long long i = begin; i < end; i++)
+			store.width[i] = rowWidth(profits + i * n, n, store.base[i]);
+	});
+
+	for (int i = 0; i < m; i++)
+		store.offset[i + 1] = store.offset[i] + rowBytes(n, store.width[i]);
+	store.data.resize(store.offset[m]);
+
+	parallelBlocks(plan, m, n, [&](int, long long begin, long long end) {
+		for (long long i = begin; i < end; i++) {
+			unsigned char *data = store.data.data() + store.offset[i];
+			if (store.width[i] == 1)
+				encodeRow<uint8_t>(profits + i * n, store.base[i], n, data);
+			else if (store.width[i] == 2)
+				encodeRow<uint16_t>(profits + i * n, store.base[i], n, data);
+			else
+				encodeRow<uint32_t>(profits + i * n, store.base[i], n, data);
+		}
+	});
+}
+
+void initCompressedProfits(int n, int m, CompressedProfits &store) {
+	store.n = n;
+	store.m = m;
+	store.base.clear();
+	store.width.clear();
+	store.offset.assign(1, 0);
+	store.data.clear();
+	store.base.reserve(m);
+	store.width.reserve(m);
+	store.offset.reserve(m + 1);
+}
+
+void appendProfits(CompressedProfits &store, const int *row) {
+	int n = store.n;
+	int low;
+	unsigned char width = rowWidth(row, n, low);
+	long long begin = store.offset.back();
+	long long end = begin + rowBytes(n, width);
+
+	// room for the rows left at the width of this one: a single allocation if the rows have the same width
+	if ((size_t)end > store.data.capacity())
+		store.data.reserve(std::max(end, begin + rowBytes(n, width) * (store.m - (long long)store.base.size())));
+	store.data.resize(end);
+
+	unsigned char *data = store.data.data() + begin;
+	if (width == 1)
+		encodeRow<uint8_t>(row, low, n, data);
+	else if (width == 2)
+		encodeRow<uint16_t>(row, low, n, data);
+	else
+		encodeRow<uint32_t>(row, low, n, data);
+
+	store.base.push_back(low);
+	store.width.push_back(width);
+	store.offset.push_back(end);
+}
+
+long long compressedBytes(const CompressedProfits &store) {
+	return (long long)store.data.size() + (long long)store.m * (sizeof(int) + sizeof(unsigned char) + sizeof(long long));
+}
+
+long long compressedBytes(int n, int m, const int *profits) {
+	long long bytes = 0;
+	for (long long i = 0; i < m; i++) {
+		int low;
+		bytes += rowBytes(n, rowWidth(profits + i * n, n, low));
+	}
+	return bytes + (long long)m * (sizeof(int) + sizeof(unsigned char) + sizeof(long long));
+}
+
+double assignedProfit(const CompressedProfits &store, const int *itemKnapsack) {
+	double objval = 0;
+	for (int j = 0; j < store.n; j++)
+		if (itemKnapsack[j] >= 0)
+			objval += profitAt(store, itemKnapsack[j], j);
+	return objval;
+}
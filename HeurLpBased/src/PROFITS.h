@@ -0,0 +1,59 @@
+#include <vector>
+#include <cstdint>
+#include <cstring>
+
+#include "PARALLEL.h"
+
+#ifndef PROFITS_H_
+#define PROFITS_H_
+
+/* compressed profit matrix: each knapsack row is stored as p(i,j) - base(i) (frame of reference, base(i) the smallest
+ * profit of the row) in 1, 2 or 4 bytes, the narrowest width that holds the range of the row; the values are decoded
+ * a block of a row at a time, so neither the n*m ints nor their copy as doubles are needed
+ * */
+struct CompressedProfits {
+	int n;
+	int m;
+	std::vector<int> base; // smallest profit of each knapsack
+	std::vector<unsigned char> width; // bytes of each value of the row: 1, 2 or 4
+	std::vector<long long> offset; // first byte of each row in data (multiple of 8)
+	std::vector<unsigned char> data;
+};
+
+// rows compressed by the threads of plan (NULL: by the caller)
+void compressProfits(int n, int m, const int *profits, const ParallelPlan *plan, CompressedProfits &store);
+
+/* empty matrix of n items and m knapsacks, filled by appendProfits a row at a time (e.g. while the instance is read,
+ * so that the n*m ints are never in memory)
+ * */
+void initCompressedProfits(int n, int m, CompressedProfits &store);
+
+// compresses the n profits of the next knapsack
+void appendProfits(CompressedProfits &store, const int *row);
+
+// bytes of the compressed matrix (n*m*4 for the ints)
+long long compressedBytes(const CompressedProfits &store);
+
+// bytes the profits would take once compressed, without compressing them
+long long compressedBytes(int n, int m, const int *profits);
+
+// p(i,j) for j in [begin, end) of the row i
+void decodeProfits(const CompressedProfits &store, int i, int begin, int end, int *values);
+void decodeProfits(const CompressedProfits &store, int i, int begin, int end, double *values);
+
+inline int profitAt(const CompressedProfits &store, int i, int j) {
+	const unsigned char *row = store.data.data() + store.offset[i];
+	switch (store.width[i]) {
+	case 1:
+		return store.base[i] + row[j];
+	case 2:
+		return store.base[i] + ((const uint16_t *)row)[j];
+	default:
+		return (int)(store.base[i] + (long long)((const uint32_t *)row)[j]);
+	}
+}
+
+// profit of the items assigned by itemKnapsack (-1: not assigned)
+double assignedProfit(const CompressedProfits &store, const int *itemKnapsack);
+
+#endif /* PROFITS_H_ */
@@ -0,0 +1,151 @@
+#include "REPORT.h"
+
+RunReport::RunReport(const char *file_name) {
+	closing = false;
+	file = fopen(file_name, "w");
+	if (file != NULL)
+		writer = std::thread(&RunReport::run, this);
+}
+
+RunReport::~RunReport() {
+	close();
+}
+
+bool RunReport::isOpen() {
+	return file != NULL;
+}
+
+void RunReport::iteration(const TraceIteration &record) {
+	TraceRecord r;
+	r.type = TRACE_ITERATION;
+	r.iteration = record;
+	push(r);
+}
+
+void RunReport::summary(const TraceSummary &record) {
+	TraceRecord r;
+	r.type = TRACE_SUMMARY;
+	r.summary = record;
+	push(r);
+}
+
+void RunReport::branchAndBound(const TraceBranchAndBound &record) {
+	TraceRecord r;
+	r.type = TRACE_BRANCH_AND_BOUND;
+	r.branchAndBound = record;
+	push(r);
+}
+
+void RunReport::perf(const PerfCounters &counters) {
+	for (int p = 0; p < PERF_PHASES; p++) {
+		if (counters.phases[p].calls == 0)
+			continue;
+		TraceRecord r;
+		r.type = TRACE_PERF;
+		r.perf.phase = p;
+		r.perf.calls = counters.phases[p].calls;
+		r.perf.time = counters.phases[p].time;
+		for (int e = 0; e < PERF_EVENTS; e++)
+			r.perf.counts[e] = counters.phases[p].counts[e];
+		push(r);
+	}
+}
+
+void RunReport::push(const TraceRecord &record) {
+	if (file == NULL)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		pending.push_back(record);
+	}
+	cv.notify_one();
+}
+
+void RunReport::close() {
+	if (file == NULL)
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		closing = true;
+	}
+	cv.notify_one();
+	writer.join();
+
+	fclose(file);
+	file = NULL;
+}
+
+void RunReport::run() {
+	BufferedWriter out(file, 1 << 16);
+	std::vector<TraceRecord> batch;
+	bool last = false;
+
+	while (!last) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cv.wait(lock, [this] { return closing || !pending.empty(); });
+			batch.swap(pending);
+			last = closing;
+		}
+
+		// formatting is done without holding the lock
+		for (size_t i = 0; i < batch.size(); i++)
+			format(out, batch[i]);
+		batch.clear();
+		out.flush();
+	}
+}
+
+void RunReport::format(BufferedWriter &out, const TraceRecord &record) {
+	if (record.type == TRACE_ITERATION) {
+		const TraceIteration &it = record.iteration;
+		out.write("{\"type\":\"iteration\",\"iteration\":"); out.write(it.iteration);
+		out.write(",\"objval\":"); out.write(it.objval);
+		out.write(",\"fractional_x\":"); out.write(it.fractionalX);
+		out.write(",\"fractional_y\":"); out.write(it.fractionalY);
+		out.write(",\"index\":"); out.write(it.index);
+		out.write(",\"value\":"); out.write(it.value);
+		out.write(",\"check\":"); out.write(it.statusCheck);
+		out.write(",\"bound_changes\":"); out.write(it.boundChanges);
+		out.write(",\"lp_time\":"); out.write(it.lpTime);
+		out.write(",\"simplex_iterations\":"); out.write(it.simplexIterations);
+		out.write("}\n");
+	}
+	else if (record.type == TRACE_SUMMARY) {
+		const TraceSummary &s = record.summary;
+		out.write("{\"type\":\"summary\",\"objval\":"); out.write(s.objval);
+		out.write(",\"iterations\":"); out.write(s.iterations);
+		out.write(",\"lp_time\":"); out.write(s.lpTime);
+		out.write(",\"time\":"); out.write(s.time);
+		out.write(",\"status\":"); out.write(s.status);
+		out.write(",\"saved_resolves\":"); out.write(s.savedResolves);
+		out.write("}\n");
+	}
+	else if (record.type == TRACE_BRANCH_AND_BOUND) {
+		const TraceBranchAndBound &bb = record.branchAndBound;
+		out.write("{\"type\":\"branch_and_bound\",\"time\":"); out.write(bb.time);
+		out.write(",\"nodes\":"); out.write(bb.nodes);
+		out.write(",\"open_nodes\":"); out.write(bb.openNodes);
+		out.write(",\"incumbent\":"); out.write(bb.incumbent);
+		out.write(",\"bound\":"); out.write(bb.bound);
+		out.write(",\"gap\":"); out.write(bb.gap);
+		out.write("}\n");
+	}
+	else if (record.type == TRACE_PERF) {
+		// events not available are null
+		const TracePerf &pf = record.perf;
+		out.write("{\"type\":\"perf\",\"phase\":\""); out.write(perfPhaseName(pf.phase));
+		out.write("\",\"calls\":"); out.write(pf.calls);
+		out.write(",\"time\":"); out.write(pf.time);
+		for (int e = 0; e < PERF_EVENTS; e++) {
+			out.write(",\""); out.write(perfEventName(e)); out.write("\":");
+			if (pf.counts[e] < 0)
+				out.write("null");
+			else
+				out.write(pf.counts[e]);
+		}
+		out.write("}\n");
+	}
+}
@@ -0,0 +1,101 @@
+#include <cstdio>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "OUTPUT.h"
+#include "PERF.h"
+
+#ifndef REPORT_H_
+#define REPORT_H_
+
+#define TRACE_ITERATION 0
+#define TRACE_SUMMARY 1
+#define TRACE_BRANCH_AND_BOUND 2
+#define TRACE_PERF 3
+
+// one LP solve of the dive and the decision taken on its solution
+struct TraceIteration {
+	int iteration;
+	double objval; // LP objective
+	int fractionalX; // number of fractional x
+	int fractionalY; // number of fractional y
+	int index; // variable chosen to be fixed (-1 if none)
+	double value; // LP value of the chosen variable
+	int statusCheck; // verdict of checkSolution
+	int boundChanges; // number of bounds changed
+	double lpTime; // wall time of the LP solve (seconds)
+	int simplexIterations;
+};
+
+// last record of the trace
+struct TraceSummary {
+	double objval;
+	int iterations;
+	double lpTime; // wall time spent in the LP solves (seconds)
+	double time; // wall time of solve (seconds)
+	int status;
+	int savedResolves; // LPs saved by the integrality tolerance (-1: not counted)
+};
+
+// progress of the branch and bound
+struct TraceBranchAndBound {
+	double time; // seconds from the start of the branch and bound
+	long long nodes; // nodes solved
+	long long openNodes;
+	double incumbent;
+	double bound;
+	double gap;
+};
+
+// hardware counters of a phase of solve (see PERF.h)
+struct TracePerf {
+	int phase;
+	long long calls;
+	double time; // wall time of the phase (seconds)
+	long long counts[PERF_EVENTS]; // -1: event not available
+};
+
+struct TraceRecord {
+	int type;
+	union {
+		TraceIteration iteration;
+		TraceSummary summary;
+		TraceBranchAndBound branchAndBound;
+		TracePerf perf;
+	};
+};
+
+// machine-readable trace of a run: one JSON record per line
+// the records are only queued by the caller and formatted/written by a writer thread
+class RunReport {
+public:
+	RunReport(const char *file_name);
+	~RunReport();
+
+	bool isOpen();
+
+	void iteration(const TraceIteration &record);
+	void summary(const TraceSummary &record);
+	void branchAndBound(const TraceBranchAndBound &record);
+	// one record for each phase with at least one call
+	void perf(const PerfCounters &counters);
+
+	// write the remaining records and stop the writer thread
+	void close();
+
+private:
+	void push(const TraceRecord &record);
+	void run();
+	void format(BufferedWriter &out, const TraceRecord &record);
+
+	FILE *file;
+	std::vector<TraceRecord> pending;
+	std::mutex mutex;
+	std::condition_variable cv;
+	std::thread writer;
+	bool closing;
+};
+
+#endif /* REPORT_H_ */
@@ -0,0 +1,304 @@
+#include "SERVER.h"
+
+struct ServerShared {
+	ServerParameters *params;
+	int listenFd;
+	std::deque<int> connections; // accepted and not yet served
+	std::mutex mutex;
+	std::condition_variable cv;
+	bool stop;
+};
+
+bool readAll(int fd, char *buffer, size_t size) {
+	size_t done = 0;
+	while (done < size) {
+		ssize_t k = read(fd, buffer + done, size - done);
+		if (k <= 0)
+			return false;
+		done += (size_t)k;
+	}
+	return true;
+}
+
+bool writeAll(int fd, const char *buffer, size_t size) {
+	size_t done = 0;
+	while (done < size) {
+		ssize_t k = send(fd, buffer + done, size - done, MSG_NOSIGNAL);
+		if (k <= 0)
+			return false;
+		done += (size_t)k;
+	}
+	return true;
+}
+
+// first line of the request, without '\n'
+bool readLine(int fd, std::string &line) {
+	line.clear();
+	char c;
+	while (line.size() < 256) {
+		if (read(fd, &c, 1) != 1)
+			return false;
+		if (c == '\n')
+			return true;
+		line += c;
+	}
+	return false;
+}
+
+void writeResult(std::ostringstream &out, int status, Solution *solution, double solveTime, double totalTime) {
+	out << "result," << status << "," << (solution != NULL ? solution->objval : 0) << "," << (solution != NULL && solution->status == 0 ? 1 : 0) << "," << solveTime << "," << totalTime << "\n";
+	// 1-based ids in the order of the .csv solution files (see writeSolutions)
+	if (solution != NULL) {
+		for (int i = 0; i < solution->m; i++) {
+			for (int j = 0; j < solution->n; j++)
+				if (solution->itemKnapsack[j] == i)
+					out << "x," << i + 1 << "," << j + 1 << "\n";
+			for (int k = 0; k < solution->r; k++)
+				if (solution->openClasses[i*solution->r + k])
+					out << "y," << i + 1 << "," << k + 1 << "\n";
+		}
+	}
+	out << "end\n";
+}
+
+// read, solve and answer one request; returns false if it is a SHUTDOWN request
+bool serveRequest(ServerShared &sh, CPXENVptr env, int fd) {
+
+	double start = wallClock();
+	std::ostringstream out;
+	out.precision(10);
+
+	std::string line;
+	char command[16];
+	double timeLimit = 0;
+	long long size = 0;
+	if (!readLine(fd, line) || sscanf(line.c_str(), "%15s", command) != 1) {
+		writeResult(out, SERVER_BAD_REQUEST, NULL, 0, wallClock() - start);
+		writeAll(fd, out.str().c_str(), out.str().size());
+		return true;
+	}
+	if (strcmp(command, "SHUTDOWN") == 0) {
+		writeResult(out, 0, NULL, 0, wallClock() - start);
+		writeAll(fd, out.str().c_str(), out.str().size());
+		return false;
+	}
+	if (strcmp(command, "SOLVE") != 0 || sscanf(line.c_str(), "%*s %lf %lld", &timeLimit, &size) != 2 || size <= 0 || size > sh.params->maxRequestSize) {
+		writeResult(out, SERVER_BAD_REQUEST, NULL, 0, wallClock() - start);
+		writeAll(fd, out.str().c_str(), out.str().size());
+		return true;
+	}
+
+	std::vector<char> data((size_t)size);
+	if (!readAll(fd, data.data(), data.size())) {
+		writeResult(out, SERVER_BAD_REQUEST, NULL, 0, wallClock() - start);
+		writeAll(fd, out.str().c_str(), out.str().size());
+		return true;
+	}
+	if (env == NULL) {
+		writeResult(out, GMKP_ERROR_ENVIRONMENT, NULL, 0, wallClock() - start);
+		writeAll(fd, out.str().c_str(), out.str().size());
+		return true;
+	}
+
+	int n, m, r;
+	int *b = NULL;
+	int *profits = NULL;
+	int *weights = NULL;
+	int *capacities = NULL;
+	int *setups = NULL;
+	int *classes = NULL;
+	int *indexes = NULL;
+
+	int status = readInstanceData(data.data(), data.size(), n, m, r, weights, capacities, profits, classes, indexes, setups, b);
+	if (status) {
+		writeResult(out, GMKP_ERROR_INSTANCE, NULL, 0, wallClock() - start);
+	}
+	else {
+		Solution solution;
+		initSolution(solution, n, m, r);
+
+		SolveParameters params;
+		initSolveParameters(params);
+		params.env = env;
+		params.verbose = false;
+		params.exactSubproblems = sh.params->exactSubproblems;
+		params.timeLimit = timeLimit > 0 ? timeLimit : sh.params->timeLimit;
+		params.TL = (int)ceil(params.timeLimit);
+
+		double solveStart = wallClock();
+		status = solve(n, m, r, b, weights, profits, capacities, setups, classes, indexes, params, solution);
+		writeResult(out, status, &solution, wallClock() - solveStart, wallClock() - start);
+
+		freeSolution(solution);
+	}
+
+	writeAll(fd, out.str().c_str(), out.str().size());
+
+	free(b);
+	free(profits);
+	free(weights);
+	free(capacities);
+	free(setups);
+	free(classes);
+	free(indexes);
+
+	return true;
+}
+
+void serverWorker(ServerShared &sh) {
+
+	// the environment is opened once and reused by all the requests of the worker
+	int status;
+	CPXENVptr env = CPXopenCPLEX(&status);
+	if (status) {
+		std::cerr << "error: GMKP server CPXopenCPLEX failed" << std::endl;
+		env = NULL;
+	}
+
+	while (true) {
+		int fd;
+		{
+			std::unique_lock<std::mutex> lock(sh.mutex);
+			sh.cv.wait(lock, [&] { return sh.stop || !sh.connections.empty(); });
+			if (sh.connections.empty())
+				break;
+			fd = sh.connections.front();
+			sh.connections.pop_front();
+		}
+
+		// a read or a write that waits longer fails, and the request is dropped
+		struct timeval timeout;
+		timeout.tv_sec = (time_t)sh.params->ioTimeout;
+		timeout.tv_usec = (suseconds_t)((sh.params->ioTimeout - (double)timeout.tv_sec) * 1e6);
+		setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+		setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+		// without an environment the requests are answered with GMKP_ERROR_ENVIRONMENT
+		bool keepRunning = serveRequest(sh, env, fd);
+		close(fd);
+
+		if (!keepRunning) {
+			std::lock_guard<std::mutex> lock(sh.mutex);
+			sh.stop = true;
+			// accept() returns at once
+			shutdown(sh.listenFd, SHUT_RDWR);
+			sh.cv.notify_all();
+		}
+	}
+
+	if (env != NULL)
+		CPXcloseCPLEX(&env);
+}
+
+void initServerParameters(ServerParameters &params) {
+	params.socketPath = "/tmp/gmkp.sock";
+	params.workers = 1;
+	params.timeLimit = 10;
+	params.exactSubproblems = true;
+	params.maxRequestSize = 1LL << 30;
+	params.ioTimeout = 30;
+}
+
+int runServer(ServerParameters &params) {
+
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (strlen(params.socketPath) >= sizeof(address.sun_path)) {
+		std::cerr << "error: GMKP server socket path too long" << std::endl;
+		return 1;
+	}
+	strcpy(address.sun_path, params.socketPath);
+
+	int listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (listenFd < 0) {
+		std::cerr << "error: GMKP server socket failed" << std::endl;
+		return 1;
+	}
+	unlink(params.socketPath);
+	if (bind(listenFd, (struct sockaddr *)&address, sizeof(address)) < 0 || listen(listenFd, 128) < 0) {
+		std::cerr << "error: GMKP server failed to listen on " << params.socketPath << std::endl;
+		close(listenFd);
+		return 1;
+	}
+
+	ServerShared sh;
+	sh.params = &params;
+	sh.listenFd = listenFd;
+	sh.stop = false;
+
+	std::vector<std::thread> workers;
+	for (int w = 0; w < (params.workers > 0 ? params.workers : 1); w++)
+		workers.push_back(std::thread(serverWorker, std::ref(sh)));
+
+	std::cout << "Server listening on " << params.socketPath << " with " << workers.size() << " workers" << std::endl;
+
+	while (true) {
+		int fd = accept(listenFd, NULL, NULL);
+		std::lock_guard<std::mutex> lock(sh.mutex);
+		if (sh.stop) {
+			if (fd >= 0)
+				close(fd);
+			break;
+		}
+		if (fd < 0)
+			continue;
+		sh.connections.push_back(fd);
+		sh.cv.notify_one();
+	}
+
+	for (size_t w = 0; w < workers.size(); w++)
+		workers[w].join();
+
+	close(listenFd);
+	unlink(params.socketPath);
+	std::cout << "Server stopped" << std::endl;
+
+	return 0;
+}
+
+int runClient(const char *socketPath, const char *instanceFile, double timeLimit, std::string &response) {
+
+	std::string request;
+	if (instanceFile == NULL) {
+		request = "SHUTDOWN\n";
+	}
+	else {
+		std::ifstream file(instanceFile, std::ios::binary);
+		if (!file.is_open())
+			return 1;
+		std::string data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+		std::ostringstream header;
+		header << "SOLVE " << timeLimit << " " << data.size() << "\n";
+		request = header.str() + data;
+	}
+
+	struct sockaddr_un address;
+	memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	if (strlen(socketPath) >= sizeof(address.sun_path))
+		return 2;
+	strcpy(address.sun_path, socketPath);
+
+	int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (fd < 0)
+		return 2;
+	if (connect(fd, (struct sockaddr *)&address, sizeof(address)) < 0 || !writeAll(fd, request.c_str(), request.size())) {
+		close(fd);
+		return 2;
+	}
+
+	response.clear();
+	char buffer[1 << 16];
+	ssize_t k;
+	while ((k = read(fd, buffer, sizeof(buffer))) > 0)
+		response.append(buffer, (size_t)k);
+	close(fd);
+
+	// the server closed the connection before the whole response
+	const std::string end = "end\n";
+	if (response.size() < end.size() || response.compare(response.size() - end.size(), end.size(), end) != 0)
+		return 3;
+
+	return 0;
+}
@@ -0,0 +1,53 @@
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "INSTANCE.h"
+#include "LPBASED_CPX.h"
+
+#ifndef SERVER_H_
+#define SERVER_H_
+
+/* protocol (one request for each connection):
+ * request:  "SOLVE <time limit in seconds, 0: default> <bytes>\n" followed by the instance (.inc or binary format),
+ *           or "SHUTDOWN\n" (the requests already accepted are completed)
+ * response: "result,<status>,<objval>,<feasible 0|1>,<solve time>,<total time>\n"
+ *           then the lines "x,knapsack,item" and "y,knapsack,class" of the solution (same lines of the .csv solution files)
+ *           and "end\n"
+ * status: 0 solved, SERVER_BAD_REQUEST (also a request not received within the timeout), GMKP_ERROR_INSTANCE (instance
+ * not read), GMKP_ERROR_ENVIRONMENT (CPLEX environment of the worker not opened), otherwise the GMKP_ERROR code of solve()
+ * */
+#define SERVER_BAD_REQUEST -1
+
+struct ServerParameters {
+	const char *socketPath; // Unix domain socket (removed and created again at the start)
+	int workers; // threads, each one with its own CPLEX environment opened once
+	double timeLimit; // time limit of a request without its own limit (seconds)
+	bool exactSubproblems;
+	long long maxRequestSize; // bytes of the largest instance accepted
+	double ioTimeout; // seconds a read or a write on a connection may wait, so that a silent client does not hold a worker
+};
+
+void initServerParameters(ServerParameters &params);
+
+// serve the requests until a SHUTDOWN request
+int runServer(ServerParameters &params);
+
+// send the instance file (path as given, not in ./instances) and put the response of the server in response
+// instanceFile NULL: send a SHUTDOWN request; returns 1 file not read, 2 server not reachable, 3 response without its end line
+int runClient(const char *socketPath, const char *instanceFile, double timeLimit, std::string &response);
+
+#endif /* SERVER_H_ */
@@ -0,0 +1,328 @@
+#include "SOLUTION.h"
+
+bool isCsv(char *file_name);
+bool sameAssignment(const Solution &a, const Solution &b);
+
+void initSolution(Solution &sol, int n, int m, int r) {
+	sol.n = n;
+	sol.m = m;
+	sol.r = r;
+	sol.itemKnapsack = (int *)malloc(sizeof(int) * n);
+	sol.openClasses = (char *)malloc(sizeof(char) * m * r);
+	sol.objval = 0;
+	sol.status = SOLUTION_NONE;
+	sol.time = 0;
+
+	for (int j = 0; j < n; j++)
+		sol.itemKnapsack[j] = -1;
+	memset(sol.openClasses, 0, sizeof(char) * m * r);
+}
+
+void freeSolution(Solution &sol) {
+	free(sol.itemKnapsack);
+	free(sol.openClasses);
+	sol.itemKnapsack = NULL;
+	sol.openClasses = NULL;
+}
+
+void copySolution(const Solution &from, Solution &to) {
+	memcpy(to.itemKnapsack, from.itemKnapsack, sizeof(int) * from.n);
+	memcpy(to.openClasses, from.openClasses, sizeof(char) * from.m * from.r);
+	to.objval = from.objval;
+	to.status = from.status;
+	to.time = from.time;
+}
+
+void solutionFromX(Solution &sol, double *x, int * profits, int * classes, int * indexes) {
+
+	int n = sol.n;
+	int m = sol.m;
+	int r = sol.r;
+
+	memset(sol.openClasses, 0, sizeof(char) * m * r);
+	sol.objval = 0;
+
+	for (int j = 0; j < n; j++)
+		sol.itemKnapsack[j] = -1;
+
+	for (int i = 0; i < m; i++)
+		for (int j = 0; j < n; j++)
+			if (x[i*n + j] > 1 - SOLUTION_EPS && sol.itemKnapsack[j] == -1) {
+				sol.itemKnapsack[j] = i;
+				if (profits != NULL)
+					sol.objval += profits[i*n + j];
+			}
+
+	for (int k = 0; k < r; k++) {
+		int indexes_prev = k > 0 ? indexes[k - 1] : 0;
+		for (int z = 0; z < indexes[k] - indexes_prev; z++) {
+			int i = sol.itemKnapsack[classes[z + indexes_prev]];
+			if (i >= 0)
+				sol.openClasses[i*r + k] = 1;
+		}
+	}
+}
+
+void solutionToX(const Solution &sol, double *x) {
+
+	int n = sol.n;
+	int m = sol.m;
+	int r = sol.r;
+
+	for (int i = 0; i < n*m + m*r; i++)
+		x[i] = 0;
+
+	for (int j = 0; j < n; j++)
+		if (sol.itemKnapsack[j] >= 0)
+			x[sol.itemKnapsack[j] * n + j] = 1;
+
+	for (int i = 0; i < m*r; i++)
+		x[m*n + i] = sol.openClasses[i];
+}
+
+void initPool(SolutionPool &pool, int capacity, int n, int m, int r) {
+	pool.capacity = capacity;
+	pool.size = 0;
+	pool.solutions = new Solution[capacity];
+	for (int s = 0; s < capacity; s++)
+		initSolution(pool.solutions[s], n, m, r);
+}
+
+void freePool(SolutionPool &pool) {
+	for (int s = 0; s < pool.capacity; s++)
+		freeSolution(pool.solutions[s]);
+	delete[] pool.solutions;
+	pool.solutions = NULL;
+	pool.size = 0;
+}
+
+bool addToPool(SolutionPool &pool, const Solution &sol) {
+
+	if (sol.status != 0 || pool.capacity == 0)
+		return false;
+
+	// position of the new solution
+	int pos = pool.size;
+	while (pos > 0 && pool.solutions[pos - 1].objval < sol.objval)
+		pos--;
+	if (pos == pool.capacity)
+		return false;
+
+	// solutions with the same value could be the same solution
+	for (int s = pos - 1; s >= 0 && pool.solutions[s].objval == sol.objval; s--)
+		if (sameAssignment(pool.solutions[s], sol))
+			return false;
+
+	// the last solution is dropped if the pool is full: its arrays are reused
+	if (pool.size == pool.capacity)
+		pool.size--;
+	Solution last = pool.solutions[pool.size];
+	for (int s = pool.size; s > pos; s--)
+		pool.solutions[s] = pool.solutions[s - 1];
+	pool.solutions[pos] = last;
+	pool.size++;
+
+	copySolution(sol, pool.solutions[pos]);
+
+	return true;
+}
+
+bool sameAssignment(const Solution &a, const Solution &b) {
+	return memcmp(a.itemKnapsack, b.itemKnapsack, sizeof(int) * a.n) == 0
+		&& memcmp(a.openClasses, b.openClasses, sizeof(char) * a.m * a.r) == 0;
+}
+
+bool isCsv(char *file_name) {
+	size_t length = strlen(file_name);
+	return length > 4 && strcmp(file_name + length - 4, ".csv") == 0;
+}
+
+/* csv format (ids start from 1, as in the .inc files):
+ *
+ * gmkp,n,m,r
+ * solution,rank,objval,status,time
+ * x,knapsack,item		one line for each assigned item
+ * y,knapsack,class		one line for each open class
+ * solution,...
+ * */
+int writeSolutions(char *file_name, Solution *solutions, int count) {
+
+	bool csv = isCsv(file_name);
+
+	FILE *file = fopen(file_name, csv ? "w" : "wb");
+	if (file == NULL)
+		return 1;
+
+	BufferedWriter out(file);
+
+	int n = count > 0 ? solutions[0].n : 0;
+	int m = count > 0 ? solutions[0].m : 0;
+	int r = count > 0 ? solutions[0].r : 0;
+
+	if (csv) {
+		out.write("gmkp,"); out.write(n); out.write(','); out.write(m); out.write(','); out.write(r); out.write('\n');
+
+		for (int s = 0; s < count; s++) {
+			Solution &sol = solutions[s];
+			out.write("solution,"); out.write(s + 1);
+			out.write(','); out.write(sol.objval);
+			out.write(','); out.write(sol.status);
+			out.write(','); out.write(sol.time);
+			out.write('\n');
+
+			for (int i = 0; i < m; i++) {
+				for (int j = 0; j < n; j++)
+					if (sol.itemKnapsack[j] == i) {
+						out.write("x,"); out.write(i + 1); out.write(','); out.write(j + 1); out.write('\n');
+					}
+				for (int k = 0; k < r; k++)
+					if (sol.openClasses[i*r + k]) {
+						out.write("y,"); out.write(i + 1); out.write(','); out.write(k + 1); out.write('\n');
+					}
+			}
+		}
+	}
+	else {
+		int header[4] = { n, m, r, count };
+		out.writeRaw(BINARY_SOLUTION_MAGIC, 8);
+		out.writeRaw(header, sizeof(header));
+
+		int bytes = (m*r + 7) / 8;
+		unsigned char *bits = (unsigned char *)malloc(bytes > 0 ? bytes : 1);
+
+		for (int s = 0; s < count; s++) {
+			Solution &sol = solutions[s];
+			out.writeRaw(&sol.objval, sizeof(double));
+			out.writeRaw(&sol.status, sizeof(int));
+			out.writeRaw(&sol.time, sizeof(double));
+			out.writeRaw(sol.itemKnapsack, sizeof(int) * n);
+
+			memset(bits, 0, bytes);
+			for (int i = 0; i < m*r; i++)
+				if (sol.openClasses[i])
+					bits[i / 8] |= (unsigned char)(1 << (i % 8));
+			out.writeRaw(bits, bytes);
+		}
+
+		free(bits);
+	}
+
+	out.flush();
+	int status = ferror(file) ? 2 : 0;
+	fclose(file);
+
+	return status;
+}
+
+int readSolutions(char *file_name, Solution * &solutions, int &count) {
+
+	solutions = NULL;
+	count = 0;
+
+	FILE *file = fopen(file_name, "rb");
+	if (file == NULL)
+		return 1;
+
+	int n, m, r;
+
+	if (isCsv(file_name)) {
+		char line[256];
+
+		if (fgets(line, sizeof(line), file) == NULL || sscanf(line, "gmkp,%d,%d,%d", &n, &m, &r) != 3) {
+			fclose(file);
+			return 2;
+		}
+
+		// first pass: number of solutions
+		while (fgets(line, sizeof(line), file) != NULL)
+			if (strncmp(line, "solution,", 9) == 0)
+				count++;
+
+		solutions = new Solution[count > 0 ? count : 1];
+		for (int s = 0; s < count; s++)
+			initSolution(solutions[s], n, m, r);
+
+		rewind(file);
+		if (fgets(line, sizeof(line), file) == NULL) {
+			fclose(file);
+			freeSolutions(solutions, count);
+			return 2;
+		}
+
+		int s = -1;
+		while (fgets(line, sizeof(line), file) != NULL) {
+			int rank, a, b;
+			if (strncmp(line, "solution,", 9) == 0) {
+				s++;
+				if (sscanf(line, "solution,%d,%lf,%d,%lf", &rank, &solutions[s].objval, &solutions[s].status, &solutions[s].time) != 4) {
+					fclose(file);
+					freeSolutions(solutions, count);
+					return 2;
+				}
+			}
+			else if (s >= 0 && sscanf(line, "x,%d,%d", &a, &b) == 2 && a >= 1 && a <= m && b >= 1 && b <= n) {
+				solutions[s].itemKnapsack[b - 1] = a - 1;
+			}
+			else if (s >= 0 && sscanf(line, "y,%d,%d", &a, &b) == 2 && a >= 1 && a <= m && b >= 1 && b <= r) {
+				solutions[s].openClasses[(a - 1)*r + b - 1] = 1;
+			}
+			else if (strcmp(line, "\n") != 0) {
+				fclose(file);
+				freeSolutions(solutions, count);
+				return 2;
+			}
+		}
+	}
+	else {
+		char magic[8];
+		int header[4];
+		if (fread(magic, 1, 8, file) != 8 || memcmp(magic, BINARY_SOLUTION_MAGIC, 8) != 0 || fread(header, sizeof(int), 4, file) != 4) {
+			fclose(file);
+			return 2;
+		}
+
+		n = header[0];
+		m = header[1];
+		r = header[2];
+		count = header[3];
+
+		solutions = new Solution[count > 0 ? count : 1];
+		for (int s = 0; s < count; s++)
+			initSolution(solutions[s], n, m, r);
+
+		int bytes = (m*r + 7) / 8;
+		unsigned char *bits = (unsigned char *)malloc(bytes > 0 ? bytes : 1);
+
+		for (int s = 0; s < count; s++) {
+			Solution &sol = solutions[s];
+			bool ok = fread(&sol.objval, sizeof(double), 1, file) == 1
+				&& fread(&sol.status, sizeof(int), 1, file) == 1
+				&& fread(&sol.time, sizeof(double), 1, file) == 1
+				&& fread(sol.itemKnapsack, sizeof(int), n, file) == (size_t)n
+				&& fread(bits, 1, bytes, file) == (size_t)bytes;
+			if (!ok) {
+				free(bits);
+				fclose(file);
+				freeSolutions(solutions, count);
+				return 3;
+			}
+
+			for (int i = 0; i < m*r; i++)
+				sol.openClasses[i] = (bits[i / 8] >> (i % 8)) & 1;
+		}
+
+		free(bits);
+	}
+
+	fclose(file);
+
+	return 0;
+}
+
+void freeSolutions(Solution * &solutions, int &count) {
+	for (int s = 0; s < count; s++)
+		freeSolution(solutions[s]);
+	delete[] solutions;
+	solutions = NULL;
+	count = 0;
+}
@@ -0,0 +1,68 @@
+#include <iostream>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+#include "OUTPUT.h"
+
+#ifndef SOLUTION_H_
+#define SOLUTION_H_
+
+// x values greater than 1 - SOLUTION_EPS are considered 1
+#define SOLUTION_EPS 1e-6
+
+// verdict of checkSolution (0 = feasible), or no solution
+#define SOLUTION_NONE -1
+
+/* binary format:
+ * magic "GMKPSOL1", n, m, r, count and then, for each solution,
+ * objval (double), status (int), time (double), knapsack of each item [n, 0-based, -1 if not assigned],
+ * open classes [m*r bits, y(i,k) is the bit i*r + k]
+ * */
+#define BINARY_SOLUTION_MAGIC "GMKPSOL1"
+
+struct Solution {
+	int n; // number of objects
+	int m; // number of knapsacks
+	int r; // number of subsets
+	int *itemKnapsack; // knapsack of each item (-1 if not assigned)
+	char *openClasses; // openClasses[i*r + k] = 1 if the class k is open in the knapsack i
+	double objval;
+	int status;
+	double time; // seconds from the start of solve
+};
+
+// pool of the best feasible solutions, sorted by decreasing objval
+struct SolutionPool {
+	int capacity;
+	int size;
+	Solution *solutions;
+};
+
+void initSolution(Solution &sol, int n, int m, int r);
+void freeSolution(Solution &sol);
+void copySolution(const Solution &from, Solution &to);
+
+// round down the LP vector x (x(i,j) first, then y(i,k)): the result satisfies all the constraints satisfied by x
+// a class is open in a knapsack only if it has items there; objval is left 0 when profits is NULL
+void solutionFromX(Solution &sol, double *x, int * profits, int * classes, int * indexes);
+
+// dense vector x (n*m + m*r) of the solution
+void solutionToX(const Solution &sol, double *x);
+
+void initPool(SolutionPool &pool, int capacity, int n, int m, int r);
+void freePool(SolutionPool &pool);
+
+// add a feasible solution if it is among the best ones and it is not already in the pool
+bool addToPool(SolutionPool &pool, const Solution &sol);
+
+// write the solutions in csv format if the name ends with .csv, in binary format otherwise
+int writeSolutions(char *file_name, Solution *solutions, int count);
+
+// read the solutions written by writeSolutions
+int readSolutions(char *file_name, Solution * &solutions, int &count);
+
+// free the solutions allocated by readSolutions
+void freeSolutions(Solution * &solutions, int &count);
+
+#endif /* SOLUTION_H_ */
@@ -0,0 +1,267 @@
+#include "STRATEGY.h"
+
+// below this number of variables one thread builds the model and checks the LP solutions faster than all the cores
+#define STRATEGY_SMALL_VARIABLES (1LL << 20)
+
+/* a rule matches when every feature is in its range; the first rule of the table that matches gives the strategy
+ * the thresholds (1M and 16M variables, 0.5 tightness and density, two items in a class) are first guesses from the
+ * structure of the dive, not yet measured: compare them with the fixed strategies on a family by -strategies
+ * */
+struct StrategyRule {
+	const char *name;
+	long long minVariables;
+	int minClasses;
+	double maxTightness; // tightness below this
+	double maxDensity; // density below this
+	double maxMeanClassSize; // mean class size not above this
+	int kind;
+};
+
+static const StrategyRule RULES[] = {
+	// many classes on a huge model: the sub-instances fit in memory and are solved at the same time
+	{ "huge model, many classes", 1LL << 24, 64, 1e30, 1e30, 1e30, STRATEGY_DECOMPOSE },
+	// few x in the optimal LP solutions: the restricted master keeps the LPs small
+	{ "large model, tight capacities", 1LL << 20, 0, 0.5, 1e30, 1e30, STRATEGY_COLGEN },
+	{ "large model, sparse profits", 1LL << 20, 0, 1e30, 0.5, 1e30, STRATEGY_COLGEN },
+	// one or two items in a class: the residual knapsacks of the open classes are almost empty
+	{ "singleton classes", 0, 0, 1e30, 1e30, 2, STRATEGY_NO_SUBSOLVER },
+	{ "default", 0, 0, 1e30, 1e30, 1e30, STRATEGY_FULL },
+};
+
+void computeFeatures(int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * indexes, InstanceFeatures &features) {
+	features.n = n;
+	features.m = m;
+	features.r = r;
+	features.variables = (long long)n * m + (long long)r * m;
+
+	long long totalWeight = 0;
+	for (int j = 0; j < n; j++)
+		totalWeight += weights[j];
+	long long totalCapacity = 0;
+	for (int i = 0; i < m; i++)
+		totalCapacity += capacities[i];
+	long long totalSetup = 0;
+	long long totalB = 0;
+	int largest = 0;
+	double squares = 0;
+	for (int k = 0; k < r; k++) {
+		totalSetup += setups[k];
+		totalB += b[k];
+		int size = findCardinalityOfClass(k, indexes);
+		largest = std::max(largest, size);
+		squares += (double)size * size;
+	}
+
+	features.tightness = totalWeight + totalSetup > 0 ? (double)totalCapacity / (totalWeight + totalSetup) : 1e30;
+	features.meanClassSize = r > 0 ? (double)n / r : 0;
+	double variance = r > 0 ? squares / r - features.meanClassSize * features.meanClassSize : 0;
+	features.classSizeCv = features.meanClassSize > 0 ? sqrt(std::max(0.0, variance)) / features.meanClassSize : 0;
+	features.largestClassShare = n > 0 ? (double)largest / n : 0;
+	features.setupWeightRatio = totalWeight > 0 ? (double)totalSetup / totalWeight : 0;
+	features.classSpread = r > 0 && m > 0 ? (double)totalB / r / m : 0;
+
+	// profits NULL (compressed): every pair counted
+	long long positive = (long long)n * m;
+	if (profits != NULL) {
+		positive = 0;
+		for (long long e = 0; e < (long long)n * m; e++)
+			if (profits[e] > 0)
+				positive++;
+	}
+	features.density = n > 0 && m > 0 ? (double)positive / ((double)n * m) : 0;
+}
+
+void printFeatures(const InstanceFeatures &features) {
+	std::cout << "Features: " << features.variables << " variables, tightness " << features.tightness << ", class size " << features.meanClassSize << " (cv " << features.classSizeCv << ", largest " << features.largestClassShare * 100 << "% of the items), setup/weight " << features.setupWeightRatio << ", density " << features.density << ", class spread " << features.classSpread << std::endl;
+}
+
+const char *strategyName(int kind) {
+	switch (kind) {
+	case STRATEGY_FULL:
+		return "full";
+	case STRATEGY_NO_SUBSOLVER:
+		return "nosubsolver";
+	case STRATEGY_COLGEN:
+		return "colgen";
+	case STRATEGY_DECOMPOSE:
+		return "decompose";
+	default:
+		return "unknown";
+	}
+}
+
+bool parseStrategy(const char *name, int &kind) {
+	if (strcmp(name, "auto") == 0) {
+		kind = STRATEGY_AUTO;
+		return true;
+	}
+	for (kind = 0; kind < STRATEGY_COUNT; kind++)
+		if (strcmp(name, strategyName(kind)) == 0)
+			return true;
+	return false;
+}
+
+void fixedStrategy(int kind, const InstanceFeatures &features, Strategy &strategy) {
+	int cores = std::max(1, (int)std::thread::hardware_concurrency());
+
+	strategy.kind = kind;
+	strategy.rule = NULL;
+	strategy.threads = features.variables < STRATEGY_SMALL_VARIABLES ? 1 : 0;
+	// a quarter of a class: the pricing adds the rest when the duals ask for it
+	strategy.columnGeneration = kind == STRATEGY_COLGEN ? std::max(1, (int)(features.meanClassSize / 4)) : 0;
+	// parts of at least 16 classes, not more than the cores
+	strategy.parts = kind == STRATEGY_DECOMPOSE ? std::max(2, std::min(cores, features.r / 16)) : 0;
+	if (kind == STRATEGY_DECOMPOSE)
+		strategy.threads = 0;
+}
+
+void selectStrategy(const InstanceFeatures &features, Strategy &strategy) {
+	int rules = sizeof(RULES) / sizeof(RULES[0]);
+	for (int t = 0; t < rules; t++) {
+		const StrategyRule &rule = RULES[t];
+		if (features.variables >= rule.minVariables && features.r >= rule.minClasses && features.tightness < rule.maxTightness && features.density < rule.maxDensity && features.meanClassSize <= rule.maxMeanClassSize) {
+			fixedStrategy(rule.kind, features, strategy);
+			strategy.rule = rule.name;
+			return;
+		}
+	}
+	fixedStrategy(STRATEGY_FULL, features, strategy);
+}
+
+int solveWithStrategy(const Strategy &strategy, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, SolveParameters &params, Solution &solution) {
+
+	if (strategy.kind == STRATEGY_DECOMPOSE) {
+		DecomposeParameters decomposeParams;
+		initDecomposeParameters(decomposeParams);
+		decomposeParams.parts = strategy.parts;
+		decomposeParams.threads = strategy.threads;
+		decomposeParams.TL = params.TL;
+		decomposeParams.exactSubproblems = true;
+		decomposeParams.verbose = params.verbose;
+		DecomposeResult result;
+		return solveDecomposed(n, m, r, b, weights, profits, capacities, setups, classes, indexes, decomposeParams, solution, result);
+	}
+
+	ParallelPlan plan;
+	initParallelPlan(plan, strategy.threads);
+	ParallelPlan *parallel = params.parallel;
+	params.parallel = &plan;
+	params.exactSubproblems = strategy.kind != STRATEGY_NO_SUBSOLVER;
+	params.columnGeneration = strategy.columnGeneration;
+	int status = solve(n, m, r, b, weights, profits, capacities, setups, classes, indexes, params, solution);
+	params.parallel = parallel;
+	return status;
+}
+
+// result of a strategy on an instance
+struct StrategyRun {
+	int status;
+	double objval;
+	bool feasible;
+	double time;
+};
+
+int runStrategyBench(const char *directory, double timeLimit) {
+
+	std::vector<std::string> names;
+	if (listInstances(directory, names))
+		return -1;
+
+	int count = (int)names.size();
+	int errors = 0;
+	int chosenBest = 0; // instances where the automatic choice has the best objective
+	int compared = 0;
+	double gapTotal = 0; // gap of the automatic choice from the best objective (%)
+	double autoTime = 0;
+	std::vector<double> fixedTime(STRATEGY_COUNT, 0);
+	std::vector<int> fixedBest(STRATEGY_COUNT, 0);
+
+	std::cout << "instance";
+	for (int kind = 0; kind < STRATEGY_COUNT; kind++)
+		std::cout << " | " << strategyName(kind);
+	std::cout << " | auto" << std::endl;
+
+	for (int c = 0; c < count; c++) {
+		int n, m, r;
+		int *b = NULL, *profits = NULL, *weights = NULL, *capacities = NULL, *setups = NULL, *classes = NULL, *indexes = NULL;
+		std::vector<char> name(names[c].begin(), names[c].end());
+		name.push_back('\0');
+		if (readInstance(name.data(), n, m, r, weights, capacities, profits, classes, indexes, setups, b)) {
+			std::cout << names[c] << ": not read" << std::endl;
+			errors++;
+			continue;
+		}
+
+		InstanceFeatures features;
+		computeFeatures(n, m, r, b, weights, profits, capacities, setups, indexes, features);
+		Strategy chosen;
+		selectStrategy(features, chosen);
+
+		// the automatic strategy is one of the fixed ones with the same settings: its run is not repeated
+		std::vector<StrategyRun> runs(STRATEGY_COUNT);
+		for (int kind = 0; kind < STRATEGY_COUNT; kind++) {
+			Strategy strategy;
+			fixedStrategy(kind, features, strategy);
+
+			Solution solution;
+			initSolution(solution, n, m, r);
+			SolveParameters params;
+			initSolveParameters(params);
+			params.verbose = false;
+			params.timeLimit = timeLimit;
+			params.TL = (int)ceil(timeLimit);
+
+			double start = wallClock();
+			runs[kind].status = solveWithStrategy(strategy, n, m, r, b, weights, profits, capacities, setups, classes, indexes, params, solution);
+			runs[kind].time = wallClock() - start;
+			runs[kind].objval = solution.objval;
+			runs[kind].feasible = runs[kind].status == 0 && solution.status == 0;
+			freeSolution(solution);
+		}
+
+		// best: the largest feasible objective, then the shortest time
+		int best = -1;
+		for (int kind = 0; kind < STRATEGY_COUNT; kind++)
+			if (runs[kind].feasible && (best < 0 || runs[kind].objval > runs[best].objval || (runs[kind].objval == runs[best].objval && runs[kind].time < runs[best].time)))
+				best = kind;
+
+		std::cout << names[c];
+		for (int kind = 0; kind < STRATEGY_COUNT; kind++) {
+			std::cout << " | ";
+			if (runs[kind].status)
+				std::cout << "error " << runs[kind].status;
+			else
+				std::cout << runs[kind].objval << (runs[kind].feasible ? "" : " (not feasible)") << " in " << runs[kind].time;
+		}
+		std::cout << " | " << strategyName(chosen.kind) << " (" << chosen.rule << ")" << std::endl;
+
+		const StrategyRun &automatic = runs[chosen.kind];
+		if (automatic.status)
+			errors++;
+		if (best >= 0) {
+			compared++;
+			fixedBest[best]++;
+			if (automatic.feasible && automatic.objval >= runs[best].objval)
+				chosenBest++;
+			gapTotal += automatic.feasible && runs[best].objval > 0 ? (runs[best].objval - automatic.objval) / runs[best].objval * 100 : 100;
+		}
+		autoTime += automatic.time;
+		for (int kind = 0; kind < STRATEGY_COUNT; kind++)
+			fixedTime[kind] += runs[kind].time;
+
+		free(b);
+		free(profits);
+		free(weights);
+		free(capacities);
+		free(setups);
+		free(classes);
+		free(indexes);
+	}
+
+	std::cout << "Strategies: " << count << " instances, " << errors << " errors" << std::endl;
+	for (int kind = 0; kind < STRATEGY_COUNT; kind++)
+		std::cout << "  " << strategyName(kind) << ": best on " << fixedBest[kind] << ", time " << fixedTime[kind] << std::endl;
+	std::cout << "  auto: best objective on " << chosenBest << " of " << compared << ", mean gap " << (compared > 0 ? gapTotal / compared : 0) << "%, time " << autoTime << std::endl;
+
+	return errors;
+}
@@ -0,0 +1,74 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "INSTANCE.h"
+#include "LPBASED_CPX.h"
+#include "DECOMPOSE.h"
+#include "BATCH.h"
+
+#ifndef STRATEGY_H_
+#define STRATEGY_H_
+
+// strategies of the solve
+#define STRATEGY_FULL 0 // dive on the full model with the exact subsolver
+#define STRATEGY_NO_SUBSOLVER 1 // dive on the full model down to the last x
+#define STRATEGY_COLGEN 2 // dive on a restricted master with pricing (see COLUMNS.h)
+#define STRATEGY_DECOMPOSE 3 // classes split in sub-instances solved in parallel (see DECOMPOSE.h)
+#define STRATEGY_COUNT 4
+#define STRATEGY_AUTO -1 // chosen by selectStrategy from the features of the instance
+
+// features of an instance, computed once after it is read
+struct InstanceFeatures {
+	int n;
+	int m;
+	int r;
+	long long variables; // x and y
+	double tightness; // sum of the capacities / (sum of the weights + sum of the setups): below 1 not every class fits
+	double meanClassSize; // items of a class
+	double classSizeCv; // coefficient of variation of the class sizes (0: all equal)
+	double largestClassShare; // items of the largest class / n
+	double setupWeightRatio; // sum of the setups / sum of the weights
+	double density; // pairs (i,j) with a positive profit / (n*m)
+	double classSpread; // mean b(k) / m: share of the knapsacks a class may use
+};
+
+void computeFeatures(int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * indexes, InstanceFeatures &features);
+
+void printFeatures(const InstanceFeatures &features);
+
+struct Strategy {
+	int kind; // STRATEGY_...
+	int columnGeneration; // x of each class in each knapsack of the restricted master (STRATEGY_COLGEN)
+	int parts; // sub-instances (STRATEGY_DECOMPOSE)
+	int threads; // threads of the model build and of the checker, or sub-instances at the same time (0: all cores)
+	const char *rule; // rule of the table that chose it (NULL: fixed by the caller)
+};
+
+const char *strategyName(int kind);
+
+// kind of a name of strategyName or "auto" (STRATEGY_AUTO); false if the name is not known
+bool parseStrategy(const char *name, int &kind);
+
+// the strategy of kind with the threads of the features (rule NULL)
+void fixedStrategy(int kind, const InstanceFeatures &features, Strategy &strategy);
+
+// the first rule of the table that matches the features
+void selectStrategy(const InstanceFeatures &features, Strategy &strategy);
+
+/* solve with the strategy: params gives the time limits, the trace and the other options of the dive
+ * (its exactSubproblems, columnGeneration and parallel are set from the strategy); 0 or a GMKP_ERROR code
+ * */
+int solveWithStrategy(const Strategy &strategy, int n, int m, int r, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes, SolveParameters &params, Solution &solution);
+
+/* every fixed strategy and the automatic one on each instance of ./instances/directory, with the given time limit:
+ * a line for each instance with the objective and the time of each strategy, then how often the choice was the best
+ * returns the number of instances not read or not solved by the automatic strategy (-1: directory not read)
+ * */
+int runStrategyBench(const char *directory, double timeLimit);
+
+#endif /* STRATEGY_H_ */
@@ -0,0 +1,185 @@
+#include "SYMMETRY.h"
+
+// bytes of the profits of the knapsack i, as stored
+const unsigned char *profitRow(int n, const int *profits, const CompressedProfits *store, int i, size_t &bytes) {
+	if (profits != NULL) {
+		bytes = sizeof(int) * n;
+		return (const unsigned char *)(profits + (size_t)i * n);
+	}
+	bytes = (size_t)store->width[i] * n;
+	return store->data.data() + store->offset[i];
+}
+
+void findKnapsackOrbits(int n, int m, const int *capacities, const int *profits, const CompressedProfits *store, const ParallelPlan *plan, KnapsackOrbits &orbits) {
+
+	// hash of the capacity and of the profits of each knapsack
+	std::vector<unsigned long long> hashes(m);
+	parallelBlocks(plan, m, n, [&](int, long long begin, long long end) {
+		for (long long i = begin; i < end; i++) {
+			unsigned long long h = mix64((unsigned long long)(unsigned int)capacities[i]);
+			// the same hash from the ints or from the compressed row
+			if (profits != NULL) {
+				const int *row = profits + i * n;
+				for (int j = 0; j < n; j++)
+					h = mix64(h ^ (unsigned long long)(unsigned int)row[j]);
+			}
+			else {
+				for (int j = 0; j < n; j++)
+					h = mix64(h ^ (unsigned long long)(unsigned int)profitAt(*store, (int)i, j));
+			}
+			hashes[i] = h;
+		}
+	});
+
+	std::vector<int> order(m);
+	for (int i = 0; i < m; i++)
+		order[i] = i;
+	std::sort(order.begin(), order.end(), [&](int a, int b) {
+		return hashes[a] != hashes[b] ? hashes[a] < hashes[b] : a < b;
+	});
+
+	orbits.count = 0;
+	orbits.knapsacks = 0;
+	orbits.orbit.assign(m, -1);
+	orbits.members.clear();
+
+	// knapsacks with the same hash: each one joins the first identical knapsack of the group
+	for (int first = 0; first < m;) {
+		int last = first;
+		while (last < m && hashes[order[last]] == hashes[order[first]])
+			last++;
+		for (int a = first; a < last; a++) {
+			int i = order[a];
+			if (orbits.orbit[i] >= 0)
+				continue;
+			std::vector<int> members(1, i);
+			for (int c = a + 1; c < last; c++) {
+				int h = order[c];
+				size_t bytesH, bytesI;
+				const unsigned char *rowH = profitRow(n, profits, store, h, bytesH);
+				const unsigned char *rowI = profitRow(n, profits, store, i, bytesI);
+				bool sameFrame = profits != NULL || store->base[h] == store->base[i];
+				if (orbits.orbit[h] < 0 && capacities[h] == capacities[i] && sameFrame && bytesH == bytesI && memcmp(rowH, rowI, bytesH) == 0)
+					members.push_back(h);
+			}
+			if (members.size() < 2)
+				continue;
+			for (size_t c = 0; c < members.size(); c++)
+				orbits.orbit[members[c]] = orbits.count;
+			orbits.knapsacks += (int)members.size();
+			orbits.members.push_back(members);
+			orbits.count++;
+		}
+		first = last;
+	}
+}
+
+int addOrbitOrdering(CPXENVptr env, CPXLPptr lp, ColumnSet *cols, const KnapsackOrbits &orbits, int n, int m, int r, int * b, int * classes, int * indexes, int &fixings, int &rows) {
+
+	fixings = 0;
+	rows = 0;
+	if (orbits.count == 0)
+		return 0;
+
+	// the knapsacks at positions 0 ... p all have a class <= k if the one at p has k: no class k with b(0) + ... + b(k) < p + 1
+	std::vector<int> indices;
+	for (int o = 0; o < orbits.count; o++) {
+		const std::vector<int> &members = orbits.members[o];
+		for (int p = 1; p < (int)members.size(); p++) {
+			int i = members[p];
+			long long open = 0;
+			for (int k = 0; k < r; k++) {
+				open += b[k];
+				if (open >= p + 1)
+					break;
+				indices.push_back(n*m + i*r + k);
+				int indexes_prev = k > 0 ? indexes[k - 1] : 0;
+				for (int z = indexes_prev; z < indexes[k]; z++)
+					indices.push_back(i*n + classes[z]);
+			}
+		}
+	}
+	if (!indices.empty()) {
+		std::vector<char> lu(indices.size(), 'U');
+		std::vector<double> bd(indices.size(), 0.0);
+		if (changeBounds(env, lp, cols, (int)indices.size(), indices.data(), lu.data(), bd.data())) {
+			std::cerr << "error: GMKP failed to change CPX bounds (orbit ordering)" << std::endl;
+			return GMKP_ERROR_MODEL;
+		}
+		fixings = (int)indices.size();
+	}
+
+	long long nonzeros = 0;
+	for (int o = 0; o < orbits.count; o++)
+		nonzeros += (long long)(orbits.members[o].size() - 1) * r * (r + 3) / 2;
+	if (nonzeros > SYMMETRY_MAX_NONZEROS)
+		return 0;
+
+	// y(p,k) - \sum_{k' <= k} y(p-1,k') <= 0 (column of y(i,k) in the lp: i*r + k in the restricted master)
+	int yOffset = cols != NULL ? 0 : n*m;
+	std::vector<int> rmatbeg;
+	std::vector<int> rmatind;
+	std::vector<double> rmatval;
+	for (int o = 0; o < orbits.count; o++) {
+		const std::vector<int> &members = orbits.members[o];
+		for (int p = 1; p < (int)members.size(); p++) {
+			int i = members[p];
+			int prev = members[p - 1];
+			for (int k = 0; k < r; k++) {
+				rmatbeg.push_back((int)rmatind.size());
+				rmatind.push_back(yOffset + i*r + k);
+				rmatval.push_back(1.0);
+				for (int h = 0; h <= k; h++) {
+					rmatind.push_back(yOffset + prev*r + h);
+					rmatval.push_back(-1.0);
+				}
+			}
+		}
+	}
+	if (rmatbeg.empty())
+		return 0;
+
+	std::vector<double> rhs(rmatbeg.size(), 0.0);
+	std::vector<char> sense(rmatbeg.size(), 'L');
+	if (CPXaddrows(env, lp, 0, (int)rmatbeg.size(), (int)rmatind.size(), rhs.data(), sense.data(), rmatbeg.data(), rmatind.data(), rmatval.data(), NULL, NULL)) {
+		std::cerr << "error: GMKP CPXaddrows (orbit ordering) failed" << std::endl;
+		return GMKP_ERROR_MODEL;
+	}
+	rows = (int)rmatbeg.size();
+	return 0;
+}
+
+void canonicalSolution(const KnapsackOrbits &orbits, Solution &sol) {
+
+	int n = sol.n;
+	int r = sol.r;
+	std::vector<int> target(sol.m);
+	for (int i = 0; i < sol.m; i++)
+		target[i] = i;
+
+	for (int o = 0; o < orbits.count; o++) {
+		const std::vector<int> &members = orbits.members[o];
+
+		// smallest open class of each knapsack (r: empty)
+		std::vector<std::pair<int, int>> smallest;
+		for (size_t c = 0; c < members.size(); c++) {
+			int k = 0;
+			while (k < r && !sol.openClasses[members[c]*r + k])
+				k++;
+			smallest.push_back(std::make_pair(k, members[c]));
+		}
+		std::stable_sort(smallest.begin(), smallest.end(), [](const std::pair<int, int> &a, const std::pair<int, int> &c) {
+			return a.first < c.first;
+		});
+		for (size_t c = 0; c < members.size(); c++)
+			target[smallest[c].second] = members[c];
+	}
+
+	for (int j = 0; j < n; j++)
+		if (sol.itemKnapsack[j] >= 0)
+			sol.itemKnapsack[j] = target[sol.itemKnapsack[j]];
+
+	std::vector<char> open(sol.openClasses, sol.openClasses + sol.m * r);
+	for (int i = 0; i < sol.m; i++)
+		memcpy(sol.openClasses + target[i]*r, open.data() + i*r, r);
+}
@@ -0,0 +1,45 @@
+#include <ilcplex/cplex.h>
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+#include "GMKP.h"
+#include "UTILITY.h"
+#include "SOLUTION.h"
+#include "PARALLEL.h"
+#include "COLUMNS.h"
+#include "PROFITS.h"
+
+#ifndef SYMMETRY_H_
+#define SYMMETRY_H_
+
+// the ordering rows are added only up to this number of nonzeros (r*(r+3)/2 for each pair of identical knapsacks)
+#define SYMMETRY_MAX_NONZEROS (1LL << 22)
+
+/* identical knapsacks: same capacity and same profits p(i,j) of all the items, so any permutation of them
+ * maps a solution to a solution with the same objective
+ * */
+struct KnapsackOrbits {
+	int count; // orbits with at least two knapsacks
+	int knapsacks; // knapsacks in these orbits
+	std::vector<int> orbit; // orbit of each knapsack (-1: no identical knapsack)
+	std::vector<std::vector<int>> members; // knapsacks of each orbit, increasing
+};
+
+// the hashes of the knapsacks are computed by the threads of plan (NULL: by the caller), equal hashes are compared
+// with profits NULL the rows of store are compared (identical rows have the same encoding)
+void findKnapsackOrbits(int n, int m, const int *capacities, const int *profits, const CompressedProfits *store, const ParallelPlan *plan, KnapsackOrbits &orbits);
+
+/* orbit ordering: the knapsacks of an orbit are sorted by the smallest class open in them (empty knapsacks last), so
+ * the knapsack at position p of its orbit has no class k with b(0) + ... + b(k) < p + 1 (bounds on y and on the x of
+ * these classes) and y(p,k) <= \sum_{k' <= k} y(p-1,k') (rows, if they have at most SYMMETRY_MAX_NONZEROS nonzeros)
+ * cols: restricted master (NULL: full model); returns 0 or GMKP_ERROR_MODEL
+ * */
+int addOrbitOrdering(CPXENVptr env, CPXLPptr lp, ColumnSet *cols, const KnapsackOrbits &orbits, int n, int m, int r, int * b, int * classes, int * indexes, int &fixings, int &rows);
+
+// permute the knapsacks of each orbit in sol so that it satisfies the orbit ordering (same objective and feasibility)
+void canonicalSolution(const KnapsackOrbits &orbits, Solution &sol);
+
+#endif /* SYMMETRY_H_ */
@@ -1,5 +1,12 @@
 #include "UTILITY.h"
 
+#include <chrono>
+#include <cmath>
+
+#ifdef __linux__
+#include <sys/resource.h>
+#endif
+
 int findClass(int item, int classes[], int indexes[], int r) {
 
 	int class1 = 0;
@@ -16,6 +23,18 @@ int findClass(int item, int classes[], int indexes[], int r) {
 	return class1;
 }
 
+void computeItemClass(int n, int r, int classes[], int indexes[], int itemClass[]) {
+
+	for (int j = 0; j < n; j++)
+		itemClass[j] = 0;
+
+	for (int k = 0; k < r; k++) {
+		int indexes_prev = k > 0 ? indexes[k - 1] : 0;
+		for (int z = 0; z < indexes[k] - indexes_prev; z++)
+			itemClass[classes[z + indexes_prev]] = k;
+	}
+}
+
 int findCardinalityOfClass(int class1, int indexes[]) {
 
 	int indexes_prev = class1 > 0 ? indexes[class1 - 1] : 0;
@@ -72,4 +91,37 @@ void copyArray(int oldArray[], int newArray[], int size) {
 	for (int i = 0; i < size; i++)
 		newArray[i] = oldArray[i];
 
-}
\ No newline at end of file
+}
+
+double wallClock() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+long long peakMemory() {
+#ifdef __linux__
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+		return (long long)usage.ru_maxrss * 1024; // kilobytes on Linux
+#endif
+	return 0;
+}
+
+// splitmix64 finalizer
+unsigned long long mix64(unsigned long long z) {
+	z += 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+int snapToIntegers(double *x, int count, double tolerance) {
+	int snapped = 0;
+	for (int i = 0; i < count; i++) {
+		double nearest = floor(x[i] + 0.5);
+		if (x[i] != nearest && fabs(x[i] - nearest) <= tolerance) {
+			x[i] = nearest;
+			snapped++;
+		}
+	}
+	return snapped;
+}
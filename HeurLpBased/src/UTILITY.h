@@ -4,6 +4,9 @@
 // find the class of an item
 int findClass(int item, int classes[], int indexes[], int r);
 
+// class of each item (same result of findClass for all the items, in O(n))
+void computeItemClass(int n, int r, int classes[], int indexes[], int itemClass[]);
+
 // find the cardinality of an class
 int findCardinalityOfClass(int class1, int indexes[]);
 
@@ -18,4 +21,16 @@ int sumAllProfitsOfClass(int item, int class1, int classes[], int indexes[], int
 
 void copyArray(int oldArray[], int newArray[], int size);
 
+// wall clock time in seconds
+double wallClock();
+
+// peak resident set size of the process in bytes (0: not available)
+long long peakMemory();
+
+// splitmix64 finalizer: counter based random numbers (same input, same output)
+unsigned long long mix64(unsigned long long z);
+
+// values of x[0 ... count-1] within tolerance of an integer are set to that integer, returns how many were changed
+int snapToIntegers(double *x, int count, double tolerance);
+
 #endif /* UTILITY_H_ */
\ No newline at end of file
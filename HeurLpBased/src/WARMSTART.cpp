@@ -0,0 +1,133 @@
+#include "WARMSTART.h"
+
+void updateObjval(Solution &sol, int * profits);
+
+void mapSolution(const Solution &prior, Solution &sol, int * profits, int * classes, int * indexes) {
+
+	int n = sol.n;
+	int m = sol.m;
+	int r = sol.r;
+
+	for (int j = 0; j < n; j++) {
+		int i = j < prior.n ? prior.itemKnapsack[j] : -1;
+		sol.itemKnapsack[j] = i >= 0 && i < m ? i : -1;
+	}
+
+	// open classes of the current instance
+	memset(sol.openClasses, 0, sizeof(char) * m * r);
+	for (int k = 0; k < r; k++) {
+		int indexes_prev = k > 0 ? indexes[k - 1] : 0;
+		for (int z = 0; z < indexes[k] - indexes_prev; z++) {
+			int i = sol.itemKnapsack[classes[z + indexes_prev]];
+			if (i >= 0)
+				sol.openClasses[i*r + k] = 1;
+		}
+	}
+
+	updateObjval(sol, profits);
+	sol.status = SOLUTION_NONE;
+	sol.time = 0;
+}
+
+int repairSolution(Solution &sol, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes) {
+
+	int n = sol.n;
+	int m = sol.m;
+	int r = sol.r;
+	int removed = 0;
+
+	int *itemClass = (int *)malloc(sizeof(int) * n);
+	computeItemClass(n, r, classes, indexes, itemClass);
+
+	// profit of each class in each knapsack, and number of items
+	std::vector<long long> classProfit((size_t)m * r, 0);
+	std::vector<int> classItems((size_t)m * r, 0);
+	for (int j = 0; j < n; j++) {
+		int i = sol.itemKnapsack[j];
+		if (i >= 0) {
+			classProfit[(size_t)i * r + itemClass[j]] += profits[i*n + j];
+			classItems[(size_t)i * r + itemClass[j]]++;
+		}
+	}
+
+	// constraint 3: keep each class only in the b(k) knapsacks where it gives more profit
+	std::vector<int> knapsacks;
+	for (int k = 0; k < r; k++) {
+		knapsacks.clear();
+		for (int i = 0; i < m; i++)
+			if (classItems[(size_t)i * r + k] > 0)
+				knapsacks.push_back(i);
+
+		if ((int)knapsacks.size() <= b[k])
+			continue;
+
+		std::sort(knapsacks.begin(), knapsacks.end(), [&](int a, int c) {
+			return classProfit[(size_t)a * r + k] > classProfit[(size_t)c * r + k];
+		});
+
+		for (size_t t = b[k]; t < knapsacks.size(); t++) {
+			int i = knapsacks[t];
+			int indexes_prev = k > 0 ? indexes[k - 1] : 0;
+			for (int z = 0; z < indexes[k] - indexes_prev; z++) {
+				int j = classes[z + indexes_prev];
+				if (sol.itemKnapsack[j] == i) {
+					sol.itemKnapsack[j] = -1;
+					removed++;
+				}
+			}
+			classItems[(size_t)i * r + k] = 0;
+			classProfit[(size_t)i * r + k] = 0;
+		}
+	}
+
+	// constraint 1: empty the overloaded knapsacks starting from the items with the lowest profit/weight
+	std::vector<int> items;
+	for (int i = 0; i < m; i++) {
+
+		long long load = 0;
+		items.clear();
+		for (int j = 0; j < n; j++)
+			if (sol.itemKnapsack[j] == i) {
+				load += weights[j];
+				items.push_back(j);
+			}
+		for (int k = 0; k < r; k++)
+			if (classItems[(size_t)i * r + k] > 0)
+				load += setups[k];
+
+		if (load <= capacities[i])
+			continue;
+
+		std::sort(items.begin(), items.end(), [&](int a, int c) {
+			return (double)profits[i*n + a] / weights[a] < (double)profits[i*n + c] / weights[c];
+		});
+
+		for (size_t t = 0; t < items.size() && load > capacities[i]; t++) {
+			int j = items[t];
+			sol.itemKnapsack[j] = -1;
+			load -= weights[j];
+			removed++;
+
+			// the last item of the class frees the setup
+			if (--classItems[(size_t)i * r + itemClass[j]] == 0)
+				load -= setups[itemClass[j]];
+		}
+	}
+
+	for (int i = 0; i < m*r; i++)
+		sol.openClasses[i] = classItems[i] > 0 ? 1 : 0;
+
+	updateObjval(sol, profits);
+	sol.status = 0;
+
+	free(itemClass);
+
+	return removed;
+}
+
+void updateObjval(Solution &sol, int * profits) {
+	sol.objval = 0;
+	for (int j = 0; j < sol.n; j++)
+		if (sol.itemKnapsack[j] >= 0)
+			sol.objval += profits[sol.itemKnapsack[j] * sol.n + j];
+}
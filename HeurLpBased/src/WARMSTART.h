@@ -0,0 +1,19 @@
+#include <vector>
+#include <algorithm>
+
+#include "SOLUTION.h"
+#include "UTILITY.h"
+
+#ifndef WARMSTART_H_
+#define WARMSTART_H_
+
+// copy the assignment of a solution of another instance of the same family (same item and knapsack ids)
+// items and knapsacks that do not exist in the current instance are dropped, classes are taken from the current instance
+void mapSolution(const Solution &prior, Solution &sol, int * profits, int * classes, int * indexes);
+
+// remove items until the solution is feasible for the current capacities and b(k)
+// first the classes open in too many knapsacks, then the items with the lowest profit/weight in the overloaded knapsacks
+// return the number of removed items
+int repairSolution(Solution &sol, int * b, int * weights, int * profits, int * capacities, int * setups, int * classes, int * indexes);
+
+#endif /* WARMSTART_H_ */